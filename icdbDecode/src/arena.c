@@ -0,0 +1,259 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "arena.h"
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stdlib.h>		// Required for malloc
+#include <string.h>		// Required for memcpy
+
+/*
+******************************************************************
+* Defines
+******************************************************************
+*/
+#define ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+#define PAYLOAD(chunk) ((uint8_t*)(chunk) + ALIGN(sizeof(arena_chunk_struct)))
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+arena_chunk_struct* newChunk(size_t);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+/*
+******************************************************************
+* - function name:	arena_alloc()
+*
+* - description: 	Takes memory from the arena. The memory is not initialized and can't be freed on its own,
+*					it is released together with all other allocations by arena_reset or arena_free
+*
+* - parameter: 		pointer to arena; number of bytes
+*
+* - return value: 	pointer to memory, NULL if out of memory
+******************************************************************
+*/
+void* arena_alloc(arena_struct* arena, size_t size)
+{
+	size_t Aligned = ALIGN(size);
+	arena_chunk_struct* Chunk = arena->Chunk;
+
+	if (Aligned < size) // Overflow
+	{
+		return NULL;
+	}
+
+	if (Chunk == NULL || Chunk->Size - Chunk->Used < Aligned)
+	{
+		if (Aligned > ARENA_CHUNK_SIZE / 4 && Chunk != NULL) // Large allocation, keep the space left in the current chunk
+		{
+			Chunk = newChunk(Aligned);
+			if (Chunk == NULL)
+			{
+				return NULL;
+			}
+			Chunk->Next = arena->Chunk->Next;
+			arena->Chunk->Next = Chunk;
+		}
+		else
+		{
+			if (Aligned <= ARENA_CHUNK_SIZE && arena->Spare != NULL) // Reuse chunk from previous run
+			{
+				Chunk = arena->Spare;
+				arena->Spare = Chunk->Next;
+			}
+			else
+			{
+				Chunk = newChunk(Aligned > ARENA_CHUNK_SIZE ? Aligned : ARENA_CHUNK_SIZE);
+				if (Chunk == NULL)
+				{
+					return NULL;
+				}
+			}
+			Chunk->Next = arena->Chunk;
+			arena->Chunk = Chunk;
+		}
+	}
+
+	arena->Last = PAYLOAD(Chunk) + Chunk->Used;
+	arena->LastChunk = Chunk;
+	Chunk->Used += Aligned;
+	return arena->Last;
+}
+
+/*
+******************************************************************
+* - function name:	arena_resize()
+*
+* - description: 	Changes the size of an allocation. The most recent allocation is resized in place if the chunk allows,
+*					all others are copied to a new allocation (the old memory stays reserved until the arena is reset)
+*
+* - parameter: 		pointer to arena; pointer to memory; current size; new size
+*
+* - return value: 	pointer to memory, NULL if out of memory (the old memory is still valid)
+******************************************************************
+*/
+void* arena_resize(arena_struct* arena, void* memory, size_t size, size_t newsize)
+{
+	uint8_t* Memory = NULL;
+
+	if (memory != NULL && memory == arena->Last)
+	{
+		size_t Offset = (uint8_t*)memory - PAYLOAD(arena->LastChunk);
+		size_t Aligned = ALIGN(newsize);
+		if (Aligned >= newsize && Aligned <= arena->LastChunk->Size - Offset)
+		{
+			arena->LastChunk->Used = Offset + Aligned;
+			return memory;
+		}
+	}
+
+	Memory = arena_alloc(arena, newsize);
+	if (Memory != NULL && memory != NULL)
+	{
+		memcpy(Memory, memory, size < newsize ? size : newsize);
+	}
+	return Memory;
+}
+
+/*
+******************************************************************
+* - function name:	arena_trim()
+*
+* - description: 	Shrinks the most recent allocation in place, giving the space behind it back to the arena.
+*					Other allocations are left untouched
+*
+* - parameter: 		pointer to arena; pointer to memory; new size
+*
+* - return value: 	-
+******************************************************************
+*/
+void arena_trim(arena_struct* arena, void* memory, size_t newsize)
+{
+	if (memory != NULL && memory == arena->Last)
+	{
+		size_t Offset = (uint8_t*)memory - PAYLOAD(arena->LastChunk);
+		if (Offset + ALIGN(newsize) <= arena->LastChunk->Used)
+		{
+			arena->LastChunk->Used = Offset + ALIGN(newsize);
+		}
+	}
+}
+
+/*
+******************************************************************
+* - function name:	arena_reset()
+*
+* - description: 	Releases all allocations of the arena at once. Regular chunks are kept for reuse,
+*					so parsing the next file of similar size does not allocate again
+*
+* - parameter: 		pointer to arena
+*
+* - return value: 	-
+******************************************************************
+*/
+void arena_reset(arena_struct* arena)
+{
+	arena_chunk_struct* Next = NULL;
+
+	for (arena_chunk_struct* Chunk = arena->Chunk; Chunk != NULL; Chunk = Next)
+	{
+		Next = Chunk->Next;
+		if (Chunk->Size == ARENA_CHUNK_SIZE) // Regular chunk, keep for the next run
+		{
+			Chunk->Used = 0;
+			Chunk->Next = arena->Spare;
+			arena->Spare = Chunk;
+		}
+		else // Chunk of a large allocation
+		{
+			free(Chunk);
+		}
+	}
+
+	arena->Chunk = NULL;
+	arena->LastChunk = NULL;
+	arena->Last = NULL;
+}
+
+/*
+******************************************************************
+* - function name:	arena_free()
+*
+* - description: 	Releases all allocations and all chunks of the arena
+*
+* - parameter: 		pointer to arena
+*
+* - return value: 	-
+******************************************************************
+*/
+void arena_free(arena_struct* arena)
+{
+	arena_chunk_struct* Next = NULL;
+
+	arena_reset(arena);
+	for (arena_chunk_struct* Chunk = arena->Spare; Chunk != NULL; Chunk = Next)
+	{
+		Next = Chunk->Next;
+		free(Chunk);
+	}
+	arena->Spare = NULL;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+/*
+******************************************************************
+* - function name:	newChunk()
+*
+* - description: 	Allocates an empty chunk
+*
+* - parameter: 		usable size of the chunk
+*
+* - return value: 	pointer to chunk, NULL if out of memory
+******************************************************************
+*/
+arena_chunk_struct* newChunk(size_t size)
+{
+	arena_chunk_struct* Chunk = NULL;
+
+	if (size > SIZE_MAX - ALIGN(sizeof(arena_chunk_struct)))
+	{
+		return NULL;
+	}
+
+	Chunk = malloc(ALIGN(sizeof(arena_chunk_struct)) + size);
+	if (Chunk != NULL)
+	{
+		Chunk->Next = NULL;
+		Chunk->Size = size;
+		Chunk->Used = 0;
+	}
+	return Chunk;
+}
@@ -0,0 +1,66 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _ARENA_H
+#define _ARENA_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define ARENA_CHUNK_SIZE	(1024 * 1024)	// Size of a regular chunk, larger allocations get a chunk of their own
+#define ARENA_ALIGNMENT		16				// Alignment of every allocation
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct arena_chunk_struct
+{
+	struct arena_chunk_struct* Next;	// Older chunk
+	size_t Size;						// Usable bytes behind the chunk header
+	size_t Used;						// Bytes handed out
+} arena_chunk_struct;
+
+typedef struct arena_struct
+{
+	arena_chunk_struct* Chunk;		// Chunk allocations are taken from, older chunks are linked behind it
+	arena_chunk_struct* Spare;		// Empty regular chunks, kept by arena_reset for reuse
+	arena_chunk_struct* LastChunk;	// Chunk of the most recent allocation
+	uint8_t* Last;					// Most recent allocation, can be resized in place
+} arena_struct;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern void* arena_alloc(arena_struct*, size_t);
+extern void* arena_resize(arena_struct*, void*, size_t, size_t);
+extern void arena_trim(arena_struct*, void*, size_t);
+extern void arena_reset(arena_struct*);
+extern void arena_free(arena_struct*);
+
+#endif //_ARENA_H
@@ -0,0 +1,334 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "batch.h"
+#include <stdio.h>		// Required for fopen, fgets
+#include <stdlib.h>		// Required for calloc to work properly
+#include <string.h>		// Required for strlen
+#include "common.h"		// Required for DIR_SEPARATOR
+#include "stringutil.h"	// Required for addStrings
+
+#ifdef WIN32 // Building for Windows
+	#include <windows.h>	// Required for FindFirstFile
+#else // Building for Unix
+	#include <dirent.h>		// Required for opendir
+	#include <sys/stat.h>	// Required for lstat, stat
+#endif
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define BATCH_LINE_LENGTH 4096		// Longest path accepted in a list file
+#define _CRT_SECURE_NO_DEPRECATE	// Disable insecure function warning in VisualStudio
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct batch_list_struct
+{
+	char** Path;		// Database paths
+	unsigned int Count;	// Number of paths
+	unsigned int Size;	// Allocated number of paths
+}batch_list_struct;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+int batch_add(batch_list_struct*, char*, size_t);
+int batch_readList(batch_list_struct*, char*);
+int batch_scanDirectory(batch_list_struct*, char*);
+int batch_isDatabase(char*);
+int batch_compare(const void*, const void*);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	batch_collect()
+*
+* - description: 	Collects the databases of a batch. A directory is searched recursively for *.dat files,
+*					any other file is read as list with one database path per line. Empty lines and lines starting with '#' are ignored
+*
+* - parameter: 		directory or list file; pointer to path array (free with batch_cleanup); pointer to number of paths
+*
+* - return value: 	error code
+******************************************************************
+*/
+int batch_collect(char* path, char*** list, unsigned int* count)
+{
+	batch_list_struct Batch = { NULL, 0, 0 };
+	int error = 0;
+#ifdef WIN32 // Building for Windows
+	DWORD Attributes = GetFileAttributesA(path);
+	if (Attributes != INVALID_FILE_ATTRIBUTES && (Attributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+#else // Building for Unix
+	struct stat PathStat;
+	if (stat(path, &PathStat) == 0 && S_ISDIR(PathStat.st_mode))
+#endif
+	{
+		error = batch_scanDirectory(&Batch, path);
+		if (Batch.Count > 1)
+		{
+			qsort(Batch.Path, Batch.Count, sizeof(char*), batch_compare); // Directory order is not defined
+		}
+	}
+	else
+	{
+		error = batch_readList(&Batch, path);
+	}
+	*list = Batch.Path;
+	*count = Batch.Count;
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	batch_cleanup()
+*
+* - description: 	Frees a path array returned by batch_collect()
+*
+* - parameter: 		pointer to path array; pointer to number of paths
+*
+* - return value: 	-
+******************************************************************
+*/
+void batch_cleanup(char*** list, unsigned int* count)
+{
+	for (unsigned int i = 0; *list != NULL && i < *count; i++)
+	{
+		free((*list)[i]);
+	}
+	free(*list);
+	*list = NULL;
+	*count = 0;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	batch_add()
+*
+* - description: 	Adds a copy of a path to the batch
+*
+* - parameter: 		pointer to batch; path; length of path
+*
+* - return value: 	error code
+******************************************************************
+*/
+int batch_add(batch_list_struct* Batch, char* path, size_t length)
+{
+	if (Batch->Count == Batch->Size)
+	{
+		unsigned int newSize = Batch->Size == 0 ? 16 : Batch->Size * 2;
+		char** newPath = realloc(Batch->Path, newSize * sizeof(char*));
+		if (newPath == NULL)
+		{
+			return -1;
+		}
+		Batch->Path = newPath;
+		Batch->Size = newSize;
+	}
+	char* copy = malloc(length + 1);
+	if (copy == NULL)
+	{
+		return -1;
+	}
+	memcpy(copy, path, length);
+	copy[length] = '\0';
+	Batch->Path[Batch->Count++] = copy;
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	batch_readList()
+*
+* - description: 	Adds all paths of a list file
+*
+* - parameter: 		pointer to batch; path of list file
+*
+* - return value: 	error code
+******************************************************************
+*/
+int batch_readList(batch_list_struct* Batch, char* path)
+{
+	char Line[BATCH_LINE_LENGTH];
+	FILE* listFile = fopen(path, "r");
+	if (listFile == NULL)
+	{
+		return -1;
+	}
+	while (fgets(Line, sizeof(Line), listFile) != NULL)
+	{
+		size_t length = strlen(Line);
+		// Strip line ending and trailing blanks
+		while (length > 0 && (Line[length - 1] == '\n' || Line[length - 1] == '\r' || Line[length - 1] == ' ' || Line[length - 1] == '\t'))
+		{
+			length--;
+		}
+		if (length == 0 || Line[0] == '#')
+		{
+			continue;
+		}
+		if (batch_add(Batch, Line, length) != 0)
+		{
+			fclose(listFile);
+			return -1;
+		}
+	}
+	fclose(listFile);
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	batch_scanDirectory()
+*
+* - description: 	Adds all *.dat files of a directory and its subdirectories.
+*					Symbolic links and junctions to directories are not followed, so a link to a parent can not loop
+*
+* - parameter: 		pointer to batch; path of directory
+*
+* - return value: 	error code
+******************************************************************
+*/
+int batch_scanDirectory(batch_list_struct* Batch, char* path)
+{
+	int error = 0;
+	char* Path = NULL;
+	uint32_t pathLength = (uint32_t)strlen(path) + 1;
+#ifdef WIN32 // Building for Windows
+	WIN32_FIND_DATAA Entry;
+	char* Pattern = NULL;
+	addStrings(&Pattern, path, pathLength, "*", sizeof("*"), DIR_SEPARATOR);
+	HANDLE Find = Pattern != NULL ? FindFirstFileA(Pattern, &Entry) : INVALID_HANDLE_VALUE;
+	free(Pattern);
+	if (Find == INVALID_HANDLE_VALUE)
+	{
+		return -1;
+	}
+	do
+	{
+		char* Name = Entry.cFileName;
+		int isDirectory = (Entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 && (Entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0;
+		int isLinkedDirectory = (Entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 && (Entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+#else // Building for Unix
+	struct dirent* Entry = NULL;
+	struct stat EntryStat;
+	DIR* Directory = opendir(path);
+	if (Directory == NULL)
+	{
+		return -1;
+	}
+	while (error == 0 && (Entry = readdir(Directory)) != NULL)
+	{
+		char* Name = Entry->d_name;
+		int isDirectory = 0;
+		int isLinkedDirectory = 0;
+#endif
+		if (strcmp(Name, ".") == 0 || strcmp(Name, "..") == 0)
+		{
+			continue;
+		}
+		uint32_t PathLength = addStrings(&Path, path, pathLength, Name, (uint32_t)strlen(Name) + 1, DIR_SEPARATOR);
+		if (Path == NULL)
+		{
+			error = -1;
+			break;
+		}
+#ifndef WIN32 // Building for Unix
+		if (lstat(Path, &EntryStat) == 0)
+		{
+			isDirectory = S_ISDIR(EntryStat.st_mode);
+			isLinkedDirectory = (S_ISLNK(EntryStat.st_mode) && stat(Path, &EntryStat) == 0 && S_ISDIR(EntryStat.st_mode));
+		}
+#endif
+		if (isDirectory)
+		{
+			error = batch_scanDirectory(Batch, Path);
+		}
+		else if (isLinkedDirectory == 0 && batch_isDatabase(Name))
+		{
+			error = batch_add(Batch, Path, PathLength);
+		}
+		free(Path);
+		Path = NULL;
+#ifdef WIN32 // Building for Windows
+	} while (error == 0 && FindNextFileA(Find, &Entry) != 0);
+	FindClose(Find);
+#else // Building for Unix
+	}
+	closedir(Directory);
+#endif
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	batch_isDatabase()
+*
+* - description: 	Checks for the .dat ending, ignoring case
+*
+* - parameter: 		file name
+*
+* - return value: 	1 for database files, 0 otherwise
+******************************************************************
+*/
+int batch_isDatabase(char* name)
+{
+	size_t length = strlen(name);
+	return length > 4 && name[length - 4] == '.' &&
+		(name[length - 3] == 'd' || name[length - 3] == 'D') &&
+		(name[length - 2] == 'a' || name[length - 2] == 'A') &&
+		(name[length - 1] == 't' || name[length - 1] == 'T');
+}
+
+/*
+******************************************************************
+* - function name:	batch_compare()
+*
+* - description: 	Compare function for sorting paths with qsort
+*
+* - parameter: 		pointers to the two path pointers
+*
+* - return value: 	strcmp result
+******************************************************************
+*/
+int batch_compare(const void* left, const void* right)
+{
+	return strcmp(*(char* const*)left, *(char* const*)right);
+}
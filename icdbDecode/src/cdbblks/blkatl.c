@@ -101,7 +101,7 @@ key_struct* Blkatl_XtrUID = NULL;
 * - return value: 	-
 ******************************************************************
 */
-void ProcessKeyBlkatl(FILE * sourceFile, char* Key, unsigned int KeyLen)
+void ProcessKeyBlkatl(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	if (strcmp(Key, "BNetFlg") == 0)
 	{
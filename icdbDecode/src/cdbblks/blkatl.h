@@ -21,8 +21,7 @@
 * Global Includes
 ******************************************************************
 */
-#include <stdio.h>		// Required for FILE
-#include "../common.h"	// Required for key_struct
+#include "../common.h"	// Required for key_struct, cursor_struct
 
 /*
 ******************************************************************
@@ -98,7 +97,7 @@ extern key_struct* Blkatl_XtrUID;
 * Global Functions
 ******************************************************************
 */
-extern void ProcessKeyBlkatl(FILE*, char*, unsigned int);
+extern void ProcessKeyBlkatl(cursor_struct*, char*, unsigned int);
 extern void InitBlkatl(void);
 
 #endif //_BLKATL_H
\ No newline at end of file
@@ -79,7 +79,7 @@ void ProcessBus(element_struct* bus)
 		for (unsigned int i = 0; i < bus->Length; i++)
 		{
 			// Bus name
-			(((bus_struct*)(bus->Data))[i]).Name = CopyString(((string_struct*)(*Blkatl_BusNam).Data)[i]);
+			(((bus_struct*)(bus->Data))[i]).Name = ViewString(((string_struct*)(*Blkatl_BusNam).Data)[i]);
 
 			// UID
 			memcpy(&(((bus_struct*)(bus->Data))[i]).UID, &(((char*)(*Blkatl_BusUID).Data)[i * 8]), 8);
@@ -109,7 +109,7 @@ void ProcessBus(element_struct* bus)
 				for (unsigned int j = 0; j < ((bus_struct*)(bus->Data))[i].BusSegmentLen; j++)
 				{
 					// Buses without custom names don't have a label entry, leading to a mismatch between Bus2GrpSegments and the other bus->Data data. Detect bus->Dataes without name ("$" Prefix) and skip them
-					if ((((bus_struct*)(bus->Data))[i]).Name.Text[0] != '$')
+					if ((((bus_struct*)(bus->Data))[i]).Name.Length == 0 || (((bus_struct*)(bus->Data))[i]).Name.Text[0] != '$')
 					{
 						if (((*Dxdatl_Bus2GrpLabels).LengthCalc > cnt) && (((int_array_struct*)(*Dxdatl_Bus2GrpSegments).Data)[i].Length == ((int_array_struct*)(*Dxdatl_Bus2GrpLabels).Data)[cnt].Length))
 						{
@@ -157,7 +157,6 @@ void InitBus(element_struct* bus)
 		for (unsigned int i = 0; i < bus->Length; i++)
 		{
 			free(((bus_struct*)(bus->Data))[i].BusSegment);
-			free(((bus_struct*)(bus->Data))[i].Name.Text);
 		}
 		free(bus->Data);
 		bus->Data = NULL;
@@ -44,7 +44,7 @@ typedef struct bus_segment_struct
 
 typedef struct bus_struct
 {
-	string_struct Name;
+	string_view_struct Name;
 	uid_union UID;
 	bus_segment_struct* BusSegment;
 	int BusSegmentLen;
@@ -98,7 +98,7 @@ int parseCdbblks(char* path, uint32_t pathlength)
 	}
 
 	InitDxdatl();
-	InitBlkatl();
+	InitBlkatl(); // Keys stay in keyArena, names and texts are views into them
 	return errorcode;
 }
 /*
@@ -90,7 +90,7 @@ void ProcessNet(element_struct* net)
 			(((net_struct*)(net->Data))[i]).NetID = ((int*)(*Dxdatl_NetID).Data)[i];
 
 			// Net name
-			(((net_struct*)(net->Data))[i]).Name = CopyString(((string_struct*)(*Dxdatl_NetLabel).Data)[i]);
+			(((net_struct*)(net->Data))[i]).Name = ViewString(((string_struct*)(*Dxdatl_NetLabel).Data)[i]);
 
 			// Segment
 			if (
@@ -141,7 +141,6 @@ void InitNet(element_struct* net)
 	{
 		for (unsigned int i = 0; i < net->Length; i++)
 		{
-			free(((net_struct*)(net->Data))[i].Name.Text);
 			free(((net_struct*)(net->Data))[i].NetSegment);
 		}
 		free(net->Data);
@@ -45,7 +45,7 @@ typedef struct net_struct
 	int Net;
 	uid_union UID;
 	int NetID;
-	string_struct Name;
+	string_view_struct Name;
 	int NumNetSegment;
 	net_segment_struct* NetSegment;
 } net_struct;
@@ -163,7 +163,7 @@ key_struct* Catlgatl_Version = NULL;
 * - return value: 	-
 ******************************************************************
 */
-void ProcessKeyCatlgatl(FILE * sourceFile, char* Key, unsigned int KeyLen)
+void ProcessKeyCatlgatl(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	if (strcmp(Key, "BlkTime") == 0)
 	{
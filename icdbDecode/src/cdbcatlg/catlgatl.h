@@ -21,8 +21,7 @@
 * Global Includes
 ******************************************************************
 */
-#include <stdio.h>		// Required for FILE
-#include "../common.h"	// Required for key_struct
+#include "../common.h"	// Required for key_struct, cursor_struct
 
 /*
 ******************************************************************
@@ -160,7 +159,7 @@ extern key_struct* Catlgatl_Version;
 * Global Functions
 ******************************************************************
 */
-extern void ProcessKeyCatlgatl(FILE*, char*, unsigned int);
+extern void ProcessKeyCatlgatl(cursor_struct*, char*, unsigned int);
 extern void InitCatlgatl(void);
 
 #endif //_CATLGATL_H
\ No newline at end of file
@@ -69,6 +69,7 @@ int parseCdbcatlg(char* path, uint32_t pathlength)
 
 	InitCatlgatl();
 	InitGrpatl();
+	arena_reset(&keyArena); // Release all parsed keys at once
 	return errorcode;
 }
 /*
@@ -58,7 +58,7 @@ key_struct* Grpatl_PrpStr = NULL;
 * - return value: 	-
 ******************************************************************
 */
-void ProcessKeyGrpatl(FILE * sourceFile, char* Key, unsigned int KeyLen)
+void ProcessKeyGrpatl(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	if (strcmp(Key, "Fixes") == 0)
 	{
@@ -21,8 +21,7 @@
 * Global Includes
 ******************************************************************
 */
-#include <stdio.h>		// Required for FILE
-#include "../common.h"	// Required for key_struct
+#include "../common.h"	// Required for key_struct, cursor_struct
 
 /*
 ******************************************************************
@@ -55,7 +54,7 @@ extern key_struct* Grpatl_PrpStr;
 * Global Functions
 ******************************************************************
 */
-extern void ProcessKeyGrpatl(FILE*, char*, unsigned int);
+extern void ProcessKeyGrpatl(cursor_struct*, char*, unsigned int);
 extern void InitGrpatl(void);
 
 #endif //_GRPATL_H
\ No newline at end of file
@@ -86,6 +86,7 @@ int ParseGrpobj(element_struct* grpobj, char* path, uint32_t pathlength, char* f
 			// Read group
 			(void)!fread(((grpobj_struct*)(grpobj->Data))[i].group, sizeof(unsigned int), ((grpobj_struct*)(grpobj->Data))[i].numGroup, sourceFile);
 		}
+		fclose(sourceFile);
 		return 0;
 	}
 	else
@@ -84,6 +84,7 @@ int parseCdbcmpcache(char* path, uint32_t pathlength)
 	
 	InitDxdatl();
 	InitCmpatl();
+	arena_reset(&keyArena); // Release all parsed keys at once
 	return errorcode;
 }
 
@@ -63,7 +63,7 @@ key_struct* Cmpatl_Version = NULL;
 * - return value: 	-
 ******************************************************************
 */
-void ProcessKeyCmpatl(FILE * sourceFile, char* Key, unsigned int KeyLen)
+void ProcessKeyCmpatl(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	if (strcmp(Key, "CmpPins") == 0)
 	{
@@ -21,8 +21,7 @@
 * Global Includes
 ******************************************************************
 */
-#include <stdio.h>		// Required for FILE
-#include "../common.h"	// Required for key_struct
+#include "../common.h"	// Required for key_struct, cursor_struct
 
 /*
 ******************************************************************
@@ -60,7 +59,7 @@ extern key_struct* Cmpatl_Version;
 * Global Functions
 ******************************************************************
 */
-extern void ProcessKeyCmpatl(FILE*, char*, unsigned int);
+extern void ProcessKeyCmpatl(cursor_struct*, char*, unsigned int);
 extern void InitCmpatl(void);
 
 #endif //_CMPATL_H
\ No newline at end of file
@@ -26,6 +26,8 @@
 #include <stdint.h>		// Required for int32_t, uint32_t, ...
 #include <string.h>		// Required for strcmp
 #include "stringutil.h"	// Required for assemblePath
+#include "vfs.h"		// Required for vfs_fopen
+#include "cursor.h"		// Required for cursor_open
 #include <math.h>		// Required for abs
 
 /*
@@ -39,14 +41,21 @@
 	#pragma message ("building 32bit application")
 #endif
 
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+arena_struct keyArena = { NULL, NULL, NULL, NULL }; // Owns all parsed keys and their payload
+
 /*
 ******************************************************************
 * Function Prototypes 
 ******************************************************************
 */
-string_struct* ParseString(FILE*, int32_t, uint32_t*);
-int_array_struct* ParseIntArray(FILE*, int32_t, uint32_t*);
-void* ParseInt(FILE*, uint32_t, uint32_t);
+string_struct* ParseString(cursor_struct*, int32_t, uint32_t*);
+int_array_struct* ParseIntArray(cursor_struct*, int32_t, uint32_t*);
+void* ParseInt(cursor_struct*, uint32_t, uint32_t);
 
 /*
 ******************************************************************
@@ -57,7 +66,7 @@ void* ParseInt(FILE*, uint32_t, uint32_t);
 ******************************************************************
 * - function name:	myfopen()
 *
-* - description: 	Create source path & open/create file
+* - description: 	Create source path & open/create file. Files held by the in memory filesystem are opened from there
 *
 * - parameter: 		fopen parameter; source path string; length of sourcepath
 *
@@ -79,7 +88,14 @@ FILE* myfopen(char* option, char* leftstring, uint32_t leftstringlength, char* r
 	}
 	if (Path != NULL)
 	{
-		returnpath = fopen(Path, option);
+		if (strcmp(option, "r") == 0 || strcmp(option, "rb") == 0)
+		{
+			returnpath = vfs_fopen(Path); // Extracted files kept in memory
+		}
+		if (returnpath == NULL)
+		{
+			returnpath = fopen(Path, option);
+		}
 		free(Path);
 	}
 	return returnpath;
@@ -112,40 +128,38 @@ char swpnib(char input)
 * - return value: 	error code
 ******************************************************************
 */
-int parseFile(char* path, uint32_t pathlength, char* file, uint32_t filelength, void(*CheckKey)(FILE*, char*, unsigned int))
+int parseFile(char* path, uint32_t pathlength, char* file, uint32_t filelength, void(*CheckKey)(cursor_struct*, char*, unsigned int))
 {
-	FILE* sourceFile;
+	cursor_struct sourceFile;
+	char* Path = NULL;
 	uint32_t KeyLength = 0;
 	char* Key = NULL;
 	uint32_t type = 0;
 	
-	// Open file
-	sourceFile = myfopen("rb", path, pathlength, file, filelength, DIR_SEPARATOR);
-	if (sourceFile != 0)
+	// Open file. The whole content is read from memory, no file operations per key
+	assemblePath(&Path, path, pathlength, file, filelength, DIR_SEPARATOR);
+	if (Path != NULL && cursor_open(Path, &sourceFile) == 0)
 	{
-		uint32_t FileStart = ftell(sourceFile);
-		fseek(sourceFile, 0, SEEK_END);
-		uint32_t FileEnd = ftell(sourceFile);
-		fseek(sourceFile, FileStart, SEEK_SET);
+		free(Path);
 
 		// Iterate over whole file
-		while(ftell(sourceFile) < FileEnd)
+		while (sourceFile.Position < sourceFile.Size)
 		{
-			(void)!fread(&KeyLength, sizeof(uint32_t), 1, sourceFile); // Get key lenght
-			if (KeyLength > 0 && KeyLength < 0xFFFFFFFF)
+			cursor_read(&sourceFile, &KeyLength, sizeof(uint32_t)); // Get key lenght
+			if (KeyLength > 0 && KeyLength <= sourceFile.Size - sourceFile.Position)
 			{
 				Key = (char*)calloc(KeyLength + 1, sizeof(char)); // Reserve memory for key + zero termination
 				if (Key != 0)
 				{
-					(void)!fread(Key, sizeof(char), KeyLength, sourceFile); // Read key
+					cursor_read(&sourceFile, Key, KeyLength); // Read key
 					Key[KeyLength] = '\0'; // Zero terminate key
 
 					// Better to be redone
-					(void)!fread(&type, sizeof(uint32_t), 1, sourceFile);
-					fseek(sourceFile, (int)sizeof(uint32_t) * -1, SEEK_CUR);
+					type = 0;
+					cursor_seek(&sourceFile, -(int64_t)cursor_read(&sourceFile, &type, sizeof(uint32_t)));
 
-					CheckKey(sourceFile, Key, KeyLength); // Process Key
-					SkipBlock(sourceFile, type); // Skip until next block
+					CheckKey(&sourceFile, Key, KeyLength); // Process Key
+					SkipBlock(&sourceFile, type); // Skip until next block
 					free(Key);
 				}
 			}
@@ -154,10 +168,12 @@ int parseFile(char* path, uint32_t pathlength, char* file, uint32_t filelength,
 				break;
 			}
 		}
+		cursor_close(&sourceFile);
 		return 0;
 	}
 	else
 	{
+		free(Path);
 		myPrint("Failed to open [%s%c%s]!\n", path, DIR_SEPARATOR, file);
 		return -1;
 	}
@@ -169,34 +185,21 @@ int parseFile(char* path, uint32_t pathlength, char* file, uint32_t filelength,
 *
 * - description: 	Skips data until the beging of the next block
 *
-* - parameter: 		pointer to source file; 1 for strings (and other 8 bit values) all other vaues for 32bit exit code
+* - parameter: 		pointer to source cursor; 1 for strings (and other 8 bit values) all other vaues for 32bit exit code
 *
 * - return value: 	-
 ******************************************************************
 */
-void SkipBlock(FILE* sourceFile, uint32_t type)
+void SkipBlock(cursor_struct* sourceFile, uint32_t type)
 {
-	uint32_t FileStart = ftell(sourceFile);
-	fseek(sourceFile, 0, SEEK_END);
-	uint32_t FileEnd = ftell(sourceFile);
-	fseek(sourceFile, FileStart, SEEK_SET);
-
-	// Skip until Magic
+	// Skip until Magic, scanning the buffer instead of reading one value at a time
 	if (type == 1) // 8 exit code
 	{
-		uint8_t Data = 0;
-		while (Data != 0xFF && ftell(sourceFile) < FileEnd)
-		{
-			(void)!fread(&Data, sizeof(uint8_t), 1, sourceFile);
-		}
+		cursor_skip_byte(sourceFile, 0xFF);
 	}
 	else // 32 bit exit code
 	{
-		uint32_t Data = 0;
-		while (Data != 0x4FFFFFFF && ftell(sourceFile) < FileEnd)
-		{
-			(void)!fread(&Data, sizeof(uint32_t), 1, sourceFile); // Read byte from file
-		}
+		cursor_skip_word(sourceFile, 0x4FFFFFFF);
 	}
 }
 /*
@@ -270,7 +273,7 @@ void numPrint(char* address, int32_t input, int32_t Ratio, int32_t Offset)
 ******************************************************************
 * - function name:	InitString()
 *
-* - description: 	Resets all strings
+* - description: 	Resets all strings. Parsed strings are owned by keyArena and released with it
 *
 * - parameter: 		number of elements; pointer to struct pointer
 *
@@ -279,17 +282,7 @@ void numPrint(char* address, int32_t input, int32_t Ratio, int32_t Offset)
 */
 void InitString(int32_t len, string_struct** structure)
 {
-	if (len > 0 && *structure != NULL)
-	{
-		for (uint32_t i = 0; i < len; i++)
-		{
-			if ((*structure)[i].Length > 0 && (*structure)[i].Text != 0)
-			{
-				free((*structure)[i].Text); // Free string
-			}
-		}
-		free(*structure); // Free Array of strings
-	}
+	(void)len; // Kept for compatibility, the strings are not freed one by one
 	*structure = NULL;
 }
 
@@ -317,21 +310,25 @@ void InitRegular(int32_t len, void** structure)
 ******************************************************************
 * - function name:	ParseKey()
 *
-* - description: 	Read data from *.v file into key_struct
+* - description: 	Read data from *.v file into key_struct. The key and its payload are allocated from keyArena
 *
-* - parameter: 		-
+* - parameter: 		pointer to source cursor
 *
 * - return value: 	pointer to key struct
 ******************************************************************
 */
-key_struct* ParseKey(FILE* sourceFile)
+key_struct* ParseKey(cursor_struct* sourceFile)
 {
-	key_struct* key = malloc(sizeof(key_struct));
+	key_struct* key = arena_alloc(&keyArena, sizeof(key_struct));
 	if (key != NULL)
 	{
-		(void)!fread(&(*key).Typecode, sizeof(uint32_t), 1, sourceFile);
-		(void)!fread(&(*key).Length, sizeof(uint32_t), 1, sourceFile);
-		fseek(sourceFile, 16, SEEK_CUR);
+		(*key).Typecode = 0;
+		(*key).Length = 0;
+		(*key).LengthCalc = 0;
+		(*key).Data = NULL;
+		cursor_read(sourceFile, &(*key).Typecode, sizeof(uint32_t));
+		cursor_read(sourceFile, &(*key).Length, sizeof(uint32_t));
+		cursor_seek(sourceFile, 16);
 
 		if ((*key).Length < 0) // ToDo: Look into negative size
 		{
@@ -343,7 +340,7 @@ key_struct* ParseKey(FILE* sourceFile)
 		case typecode_String:
 			(*key).Data = ParseString(sourceFile, (*key).Length, (uint32_t*) &(*key).LengthCalc);
 			break;
-		case typecode_IntArray:
+		case typecode_IntArray: // Table and payload share one block
 			(*key).Data = ParseIntArray(sourceFile, (*key).Length, (uint32_t*) &(*key).LengthCalc);
 			break;
 		case typecode_UID:
@@ -385,7 +382,7 @@ key_struct* ParseKey(FILE* sourceFile)
 ******************************************************************
 * - function name:	InitKey()
 *
-* - description: 	Initializes data in a key struct
+* - description: 	Initializes a key pointer
 *
 * - parameter: 		pointer to key structure to initialize
 *
@@ -394,85 +391,59 @@ key_struct* ParseKey(FILE* sourceFile)
 */
 void InitKey(key_struct** key)
 {
-	if (*key != NULL)
-	{
-		switch ((*key)->Typecode)
-		{
-		case typecode_String:
-		case typecode_IntArray:
-			if ((*key)->Data != NULL)
-			{
-				for (unsigned int i = 0; i < (*key)->LengthCalc; i++)
-				{
-					if ((((int_array_struct*)(*key)->Data)[i]).Data != NULL)
-					{
-						free((((int_array_struct*)(**key).Data)[i]).Data);
-					}
-				}
-				free((*key)->Data);
-			}
-			break;
-		case typecode_UID:
-		case typecode_Long:
-		case typecode_SUID:
-		case typecode_LongLong:
-		case typecode_Time:
-		case typecode_Int:
-		case typecode_GUID:
-			if ((*key)->Data != NULL )
-			{
-				free((*key)->Data);
-			}
-			break;
-		default:
-			break;
-		}
-
-		free(*key);
-		*key = NULL;
-	}
+	*key = NULL; // Key and payload are owned by keyArena, released with arena_reset
 }
 
 /*
 ******************************************************************
 * - function name:	ParseString()
 *
-* - description: 	Parsing code for strings
+* - description: 	Parsing code for strings. The payload is decoded in a single pass into one block,
+*					holding the string table followed by the zero terminated characters of all entries
 *
-* - parameter: 		pointer to source file; pointer to number of elements to read; name of parameter (for error messages)
+* - parameter: 		pointer to source cursor; payload length from key header; pointer to number of elements read
 *
 * - return value: 	pointer to parsed data
 ******************************************************************
 */
-string_struct* ParseString(FILE* sourceFile, int32_t PayloadLenRaw, uint32_t* NumElements)
+string_struct* ParseString(cursor_struct* sourceFile, int32_t PayloadLenRaw, uint32_t* NumElements)
 {
 	*NumElements = 0;
 	uint8_t EntryLen8 = 0;
 	uint32_t EntryLen32 = 0;
-	string_struct* Struct = NULL;
+	uint32_t Length = 0;
+	size_t Read = 0;
 	uint32_t SizeAccumulator = 0;
+	size_t Remaining = sourceFile->Size - sourceFile->Position;
+
+	// Size block from payload length (12 + rounded characters per entry). Every entry uses at least one byte of the file
+	size_t MaxElements = min((size_t)PayloadLenRaw / 12 + 1, Remaining);
+	size_t TableSize = MaxElements * sizeof(string_struct);
+	size_t Capacity = TableSize + min((size_t)PayloadLenRaw, Remaining + MaxElements) + 1;
+	size_t Used = TableSize;
+	uint8_t* Block = arena_alloc(&keyArena, Capacity);
+	uint8_t* Grown = NULL;
+	if (Block == NULL)
+	{
+		return NULL;
+	}
 
-	uint32_t FileStart = ftell(sourceFile);
-	fseek(sourceFile, 0, SEEK_END);
-	uint32_t FileEnd = ftell(sourceFile);
-	fseek(sourceFile, FileStart, SEEK_SET);
-
-	// Count Entry (I haven't found a way to derive the number)
-	while (PayloadLenRaw > SizeAccumulator && ftell(sourceFile) < FileEnd)
+	while (PayloadLenRaw > SizeAccumulator && sourceFile->Position < sourceFile->Size && *NumElements < MaxElements) // Table size is never exceeded, even if SizeAccumulator wraps
 	{
-		(void)!fread(&EntryLen8, sizeof(uint8_t), 1, sourceFile);
 		// Get file entry
+		EntryLen8 = 0xff;
+		cursor_read(sourceFile, &EntryLen8, sizeof(uint8_t));
 		if (EntryLen8 == 0xfd) // More than 255 char in this string
 		{
-			(void)!fread(&EntryLen32, sizeof(uint32_t), 1, sourceFile);
-			fseek(sourceFile, EntryLen32, SEEK_CUR);
-			(*NumElements)++;
+			EntryLen32 = 0;
+			cursor_read(sourceFile, &EntryLen32, sizeof(uint32_t));
 			SizeAccumulator += 12 + 4 * (EntryLen32 / 4); // Always round to 4 character
+			Length = (uint32_t)min((size_t)EntryLen32, sourceFile->Size - sourceFile->Position);
 		}
 		else if (EntryLen8 == 0xfe) // Padding block. Skip next block
 		{
-			//fseek(sourceFile, sizeof(uint32_t), SEEK_CUR);
-			(void)!fread(&EntryLen32, sizeof(uint32_t), 1, sourceFile);
+			cursor_read(sourceFile, &EntryLen32, sizeof(uint32_t));
+			continue;
 		}
 		else if (EntryLen8 == 0xff) // No more entry�s
 		{
@@ -480,58 +451,39 @@ string_struct* ParseString(FILE* sourceFile, int32_t PayloadLenRaw, uint32_t* Nu
 		}
 		else // Regular entry
 		{
-			fseek(sourceFile, EntryLen8, SEEK_CUR);
-			(*NumElements)++;
 			SizeAccumulator += 12 + 4 * (EntryLen8 / 4); // Always round to 4 character
+			Length = EntryLen8;
 		}
-	}
-	// Seek back to begining of block
-	fseek(sourceFile, FileStart, SEEK_SET);
 
-	Struct = calloc(*NumElements, sizeof(string_struct));
-	if (Struct != NULL)
-	{
-		for (uint32_t i = 0; i < *NumElements;)
+		// Only a last entry exceeding the payload length needs more space
+		if (Used + Length + 1 > Capacity)
 		{
-			// Get file entry
-			(void)!fread(&EntryLen8, sizeof(uint8_t), 1, sourceFile);
-			if (EntryLen8 == 0xfd) // More than 255 char in this string
-			{
-				(void)!fread(&Struct[i].Length, sizeof(uint32_t), 1, sourceFile);
-				Struct[i].Text = (char*)calloc(Struct[i].Length + 1, sizeof(char));
-				if (Struct[i].Text != NULL)
-				{
-					(void)!fread(Struct[i].Text, sizeof(char), Struct[i].Length, sourceFile);
-					Struct[i].Text[Struct[i].Length] = '\0'; // Zero terminate string
-				}
-				i++;
-			}
-			else if (EntryLen8 == 0xfe) // Unknown. Skip next block
-			{
-				(void)!fread(&EntryLen32, sizeof(uint32_t), 1, sourceFile);
-			}
-			else if (EntryLen8 == 0xff) // No more entry�s
+			Grown = arena_resize(&keyArena, Block, Used, max(Capacity * 2, Used + Length + 1));
+			if (Grown == NULL)
 			{
 				break;
 			}
-			//else if (EntryLen8 == 0) // length 0
-			//{
-			//	break;
-			//}
-			else // Regular entry
-			{
-				Struct[i].Length = EntryLen8;
-				Struct[i].Text = (char*)calloc(Struct[i].Length + 1, sizeof(char));
-				if (Struct[i].Text != NULL)
-				{
-					(void)!fread(Struct[i].Text, sizeof(char), Struct[i].Length, sourceFile);
-					Struct[i].Text[Struct[i].Length] = '\0'; // Zero terminate String
-				}
-				i++;
-			}
+			Block = Grown;
+			Capacity = max(Capacity * 2, Used + Length + 1);
 		}
-		// Seek back to not skip encode
-		fseek(sourceFile, (int)sizeof(uint8_t) * -1, SEEK_CUR);
+		((string_struct*)Block)[*NumElements].Length = Length;
+		Read = cursor_read(sourceFile, Block + Used, Length);
+		memset(Block + Used + Read, 0, Length + 1 - Read); // Zero terminate string
+		Used += Length + 1;
+		(*NumElements)++;
+	}
+	// Seek back to not skip encode
+	cursor_seek(sourceFile, (int)sizeof(uint8_t) * -1);
+
+	arena_trim(&keyArena, Block, Used); // Return unused space to the arena
+
+	// Link strings to their text, the block is not moved anymore
+	string_struct* Struct = (string_struct*)Block;
+	char* Text = (char*)Block + TableSize;
+	for (uint32_t i = 0; i < *NumElements; i++)
+	{
+		Struct[i].Text = Text;
+		Text += Struct[i].Length + 1;
 	}
 	return Struct;
 }
@@ -540,98 +492,101 @@ string_struct* ParseString(FILE* sourceFile, int32_t PayloadLenRaw, uint32_t* Nu
 ******************************************************************
 * - function name:	ParseIntArray()
 *
-* - description: 	Parsing code for strings
+* - description: 	Parsing code for int arrays. The payload is decoded in a single pass into one block,
+*					holding the array table followed by the data of all entries
 *
-* - parameter: 		pointer to source file; pointer to number of elements to read; name of parameter (for error messages)
+* - parameter: 		pointer to source cursor; payload length from key header; pointer to number of elements read
 *
 * - return value: 	pointer to parsed data
 ******************************************************************
 */
-int_array_struct* ParseIntArray(FILE* sourceFile, int32_t PayloadLenRaw, uint32_t* NumElements)
+int_array_struct* ParseIntArray(cursor_struct* sourceFile, int32_t PayloadLenRaw, uint32_t* NumElements)
 {
 	*NumElements = 0;
 	uint32_t EntryLen = 0;
-	int_array_struct* Struct = NULL;
+	uint32_t Length = 0;
 	uint32_t SizeAccumulator = 0;
 
 	uint32_t blockaddress;	// Just a guess
-	(void)!fread(&blockaddress, sizeof(uint32_t), 1, sourceFile);
-
-	uint32_t FileStart = ftell(sourceFile);
-	fseek(sourceFile, 0, SEEK_END);
-	uint32_t FileEnd = ftell(sourceFile);
-	fseek(sourceFile, FileStart, SEEK_SET);
+	cursor_read(sourceFile, &blockaddress, sizeof(uint32_t));
+
+	size_t Remaining = sourceFile->Size - sourceFile->Position;
+
+	// Size block from payload length (8 + bytes per entry). Every entry uses at least one length value of the file
+	size_t MaxElements = min((size_t)PayloadLenRaw / 8 + 1, Remaining / sizeof(uint32_t) + 1);
+	size_t TableSize = MaxElements * sizeof(int_array_struct);
+	size_t Capacity = TableSize + min((size_t)PayloadLenRaw, Remaining) + 1;
+	size_t Used = TableSize;
+	uint8_t* Block = arena_alloc(&keyArena, Capacity);
+	uint8_t* Grown = NULL;
+	if (Block == NULL)
+	{
+		return NULL;
+	}
 
-	// Count Entry (I haven't found a way to derive the number)
-	while (PayloadLenRaw > SizeAccumulator && ftell(sourceFile) < FileEnd)
+	while (PayloadLenRaw > SizeAccumulator && sourceFile->Position < sourceFile->Size && *NumElements < MaxElements) // Table size is never exceeded, even if SizeAccumulator wraps
 	{
-		fseek(sourceFile, EntryLen * sizeof(uint32_t), SEEK_CUR);
-		(void)!fread(&EntryLen, sizeof(uint32_t), 1, sourceFile);
-	
+		EntryLen = 0x4FFFFFFF;
+		cursor_read(sourceFile, &EntryLen, sizeof(uint32_t));
 		if (EntryLen == 0x4FFFFFFF) // No more entry�s
 		{
 			break;
 		}
-		else if (EntryLen == 0x4FFFFFFE) // Unknown. Skip next block
+		else if (EntryLen == 0x4FFFFFFE) // Padding
 		{
-			(void)!fread(&blockaddress, sizeof(uint32_t), 1, sourceFile);
-			EntryLen = 0;
+			cursor_read(sourceFile, &blockaddress, sizeof(uint32_t));
+			continue;
 		}
-		else
-		{
-			(*NumElements)++;
-			SizeAccumulator += 8 + (EntryLen * sizeof(uint32_t));
-		}
-	}
-	// Seek back to begining of block
-	fseek(sourceFile, FileStart, SEEK_SET);
 
-	Struct = calloc(*NumElements, sizeof(int_array_struct));
-	if (Struct != NULL)
-	{
-		for (uint32_t i = 0; i < *NumElements;)
+		SizeAccumulator += 8 + (EntryLen * sizeof(uint32_t));
+		Length = (uint32_t)min((size_t)EntryLen, (sourceFile->Size - sourceFile->Position) / sizeof(uint32_t));
+
+		// Only a last entry exceeding the payload length needs more space
+		if (Used + Length * sizeof(uint32_t) > Capacity)
 		{
-			(void)!fread(&EntryLen, sizeof(uint32_t), 1, sourceFile);
-			if (EntryLen == 0x4FFFFFFF) // No more entry�s
+			Grown = arena_resize(&keyArena, Block, Used, max(Capacity * 2, Used + Length * sizeof(uint32_t)));
+			if (Grown == NULL)
 			{
 				break;
 			}
-			else if (EntryLen == 0x4FFFFFFE) // Padding
-			{
-				(void)!fread(&blockaddress, sizeof(uint32_t), 1, sourceFile);
-			}
-			else
-			{
-				Struct[i].Length = EntryLen;
-				Struct[i].Data = (IntData*)calloc(Struct[i].Length, sizeof(uint32_t));
-				if (Struct[i].Data != NULL)
-				{
-					(void)!fread(Struct[i].Data, sizeof(uint32_t), Struct[i].Length, sourceFile);
-				}
-				i++;
-			}
+			Block = Grown;
+			Capacity = max(Capacity * 2, Used + Length * sizeof(uint32_t));
 		}
-		// Seek back to not skip encode
-		fseek(sourceFile, (int)sizeof(uint32_t) * -1, SEEK_CUR);
+		((int_array_struct*)Block)[*NumElements].Length = Length;
+		cursor_read(sourceFile, Block + Used, Length * sizeof(uint32_t));
+		Used += Length * sizeof(uint32_t);
+		(*NumElements)++;
+	}
+	// Seek back to not skip encode
+	cursor_seek(sourceFile, (int)sizeof(uint32_t) * -1);
+
+	arena_trim(&keyArena, Block, Used); // Return unused space to the arena
+
+	// Link arrays to their data, the block is not moved anymore
+	int_array_struct* Struct = (int_array_struct*)Block;
+	uint8_t* Data = Block + TableSize;
+	for (uint32_t i = 0; i < *NumElements; i++)
+	{
+		Struct[i].Data = (IntData*)Data;
+		Data += Struct[i].Length * sizeof(uint32_t);
 	}
 	return Struct;
 }
 
-
 /*
 ******************************************************************
 * - function name:	Parse()
 *
 * - description: 	Default parsing code
 *
-* - parameter: 		pointer to source file; pointer to number of elements to read; size of structure;
+* - parameter: 		pointer to source cursor; pointer to number of elements to read; size of structure;
 *					size of struct on most cases but sizeof(uint32_t) on coordinate structs (DXD seams to store coordinates separately, but storing them as struct makes more sense IMHO);
 *					name of parameter (for error messages)
 *
 * - return value: 	pointer to parsed data
 ******************************************************************
 */
-void* ParseInt(FILE* sourceFile, uint32_t NumElements, uint32_t strutSize)
+void* ParseInt(cursor_struct* sourceFile, uint32_t NumElements, uint32_t strutSize)
 {
 	uint32_t Magic;
 	int32_t Repetitions;
@@ -639,24 +594,21 @@ void* ParseInt(FILE* sourceFile, uint32_t NumElements, uint32_t strutSize)
 	uint32_t structSize32 = (strutSize / sizeof(uint32_t));
 
 	uint32_t blockaddress;	// Just a guess
-	(void)!fread(&blockaddress, sizeof(uint32_t), 1, sourceFile);
+	cursor_read(sourceFile, &blockaddress, sizeof(uint32_t));
 
-	uint32_t FileStart = ftell(sourceFile);
-	fseek(sourceFile, 0, SEEK_END);
-	uint32_t FileEnd = ftell(sourceFile);
-	fseek(sourceFile, FileStart, SEEK_SET);
-
-	Struct = calloc(NumElements, strutSize);
+	Struct = arena_alloc(&keyArena, (size_t)NumElements * strutSize);
 	if (Struct != NULL)
 	{
-		for (uint32_t i = 0; i < NumElements;)
+		uint32_t i = 0;
+		while (i < NumElements)
 		{
 			// Check entry for magic values
-			(void)!fread(&Magic, sizeof(uint32_t), 1, sourceFile);
+			Magic = 0x4FFFFFFF;
+			cursor_read(sourceFile, &Magic, sizeof(uint32_t));
 			if (Magic == 0x4FFFFFFC) // Increasing value
 			{
-				(void)!fread(&Repetitions, sizeof(uint32_t), 1, sourceFile);
-				while (Repetitions != 0 && i < NumElements && ftell(sourceFile) < FileEnd)
+				cursor_read(sourceFile, &Repetitions, sizeof(uint32_t));
+				while (Repetitions != 0 && i < NumElements && sourceFile->Position < sourceFile->Size)
 				{
 					for (uint32_t j = 0; j < structSize32; j++) // Copy whole struct
 					{
@@ -675,8 +627,8 @@ void* ParseInt(FILE* sourceFile, uint32_t NumElements, uint32_t strutSize)
 			}
 			else if (Magic == 0x4FFFFFFD) // Repeated value
 			{
-				(void)!fread(&Repetitions, sizeof(uint32_t), 1, sourceFile);
-				while (Repetitions != 0 && i < NumElements && ftell(sourceFile) < FileEnd)
+				cursor_read(sourceFile, &Repetitions, sizeof(uint32_t));
+				while (Repetitions != 0 && i < NumElements && sourceFile->Position < sourceFile->Size)
 				{
 					for (uint32_t j = 0; j < structSize32; j++) // Copy whole struct
 					{
@@ -688,7 +640,7 @@ void* ParseInt(FILE* sourceFile, uint32_t NumElements, uint32_t strutSize)
 			}
 			else if (Magic == 0x4FFFFFFE) // Unknown. Skip next block
 			{
-				(void)!fread(&blockaddress, sizeof(uint32_t), 1, sourceFile);
+				cursor_read(sourceFile, &blockaddress, sizeof(uint32_t));
 			}
 			else if (Magic == 0x4FFFFFFF) // No more entry�s
 			{
@@ -696,15 +648,16 @@ void* ParseInt(FILE* sourceFile, uint32_t NumElements, uint32_t strutSize)
 			}
 			else // Regular entry
 			{
-				// No magic, seek back & read
-				fseek(sourceFile, (int)sizeof(uint32_t) * -1, SEEK_CUR);
-				(void)!fread(Struct + (i * structSize32), strutSize, 1, sourceFile);
+				// No magic, step back & read
+				cursor_seek(sourceFile, (int)sizeof(uint32_t) * -1);
+				cursor_read(sourceFile, Struct + (i * structSize32), strutSize);
 				i++;
 			}
 		}
+		memset(Struct + (i * structSize32), 0, (size_t)(NumElements - i) * strutSize); // Clear entries not found in the file
 	}
 	// Seek back for Skip function to work
-	fseek(sourceFile, (int)sizeof(uint32_t) * -1, SEEK_CUR);
+	cursor_seek(sourceFile, (int)sizeof(uint32_t) * -1);
 	return (void*)Struct;
 }
 
@@ -733,4 +686,23 @@ string_struct CopyString(string_struct Input)
 	memcpy(Output.Text, Input.Text, Output.Length + 1);
 	Output.Text[Output.Length] = '\0'; // Zero terminate
 	return Output;
+}
+
+/*
+******************************************************************
+* - function name:	ViewString()
+*
+* - description: 	Creates a view on a parsed string without copying it. The view is valid as long as the parsed keys
+*
+* - parameter: 		String to view
+*
+* - return value: 	view on the string
+******************************************************************
+*/
+string_view_struct ViewString(string_struct Input)
+{
+	string_view_struct Output;
+	Output.Length = Input.Length;
+	Output.Text = Input.Text;
+	return Output;
 }
\ No newline at end of file
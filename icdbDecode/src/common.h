@@ -24,6 +24,8 @@
 #include <stdint.h>		// Required for int32_t, uint32_t, ...
 #include <stdio.h>		// Required for file type
 #include <stdlib.h>		// Required for min/max
+#include "cursor.h"		// Required for cursor_struct
+#include "arena.h"		// Required for arena_struct
 
 /*
 ******************************************************************
@@ -167,6 +169,12 @@ typedef struct string_struct
 	char* Text;
 } string_struct;
 
+typedef struct string_view_struct
+{
+	uint32_t Length;
+	const char* Text;	// Not owned and not zero terminated, points into the parsed keys (valid until keyArena is reset)
+} string_view_struct;
+
 typedef struct int_array_struct
 {
 	uint32_t Length;
@@ -187,6 +195,13 @@ typedef struct element_struct
 	void* Data;
 } element_struct;
 
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+extern arena_struct keyArena;
+
 /*
 ******************************************************************
 * Global Functions
@@ -195,14 +210,15 @@ typedef struct element_struct
 extern FILE* myfopen(char*, char*, uint32_t, char*, uint32_t, char);
 extern void myPrint(const char*, ...);
 extern char swpnib(char);
-extern int parseFile(char*, uint32_t, char*, uint32_t, void(*CheckKey)(FILE*, char*,  unsigned int));
-extern void SkipBlock(FILE*, uint32_t);
+extern int parseFile(char*, uint32_t, char*, uint32_t, void(*CheckKey)(cursor_struct*, char*,  unsigned int));
+extern void SkipBlock(cursor_struct*, uint32_t);
 extern void numPrint(char*, int32_t, int32_t, int32_t);
 extern void InitString(int32_t, string_struct**);
 extern void InitRegular(int32_t, void**);
-extern key_struct* ParseKey(FILE*);
+extern key_struct* ParseKey(cursor_struct*);
 extern void InitKey(key_struct**);
 string_struct CopyString(string_struct);
+extern string_view_struct ViewString(string_struct);
 
 
 #endif //_COMMON_H
\ No newline at end of file
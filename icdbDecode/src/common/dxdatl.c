@@ -192,7 +192,7 @@ key_struct* Dxdatl_Version = NULL;
 * - return value: 	-
 ******************************************************************
 */
-void ProcessKeyDxdatl(FILE * sourceFile, char* Key, unsigned int KeyLen)
+void ProcessKeyDxdatl(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	if (strcmp(Key, "Arc2Style") == 0)
 	{
@@ -21,8 +21,7 @@
 * Global Includes
 ******************************************************************
 */
-#include <stdio.h>		// Required for FILE
-#include "../common.h"	// Required for key_struct
+#include "../common.h"	// Required for key_struct, cursor_struct
 
 /*
 ******************************************************************
@@ -189,7 +188,7 @@ extern key_struct* Dxdatl_Version;
 * Global Functions
 ******************************************************************
 */
-extern void ProcessKeyDxdatl(FILE*, char*, unsigned int);
+extern void ProcessKeyDxdatl(cursor_struct*, char*, unsigned int);
 extern void InitDxdatl(void);
 
 #endif //_DXDATL_H
\ No newline at end of file
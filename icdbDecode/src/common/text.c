@@ -63,7 +63,7 @@ void ProcessText(element_struct* text, element_struct* textdata)
 		for (unsigned int i = 0; i < text->Length; i++)
 		{
 			// String
-			(((text_struct*)(text->Data))[i]).String = CopyString(((string_struct*)(*Dxdatl_TextString).Data)[i]);
+			(((text_struct*)(text->Data))[i]).String = ViewString(((string_struct*)(*Dxdatl_TextString).Data)[i]);
 
 			// UID
 			memcpy(&(((text_struct*)(text->Data))[i]).UID, &(((char*)(*Dxdatl_TextUID).Data)[i*8]), 8);
@@ -93,11 +93,7 @@ void InitText(element_struct* text)
 {
 	if (text->Length != 0 && text->Data != NULL)
 	{
-		for(unsigned int i = 0; i< text->Length; i++)
-		{
-			free((((text_struct*)(text->Data))[i]).String.Text);
-		}
-		free(text->Data);
+		free(text->Data); // Strings are views into the parsed keys
 		text->Data = NULL;
 		text->Length = 0;
 	}
@@ -33,7 +33,7 @@
 */
 typedef struct text_struct
 {
-	string_struct String;
+	string_view_struct String;
 	textdata_struct TextData;
 	uid_union UID;
 } text_struct;
@@ -0,0 +1,505 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "cursor.h"
+#include <stdio.h>		// Required for fopen
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcpy
+#include "vfs.h"		// Required for vfs_data
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CURSOR_SSE2
+	#include <emmintrin.h>	// Required for _mm_cmpeq_epi8
+#endif
+#ifdef __AVX2__
+	#define CURSOR_AVX2
+	#include <immintrin.h>	// Required for _mm256_cmpeq_epi8
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>		// Required for _BitScanForward
+#endif
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct kernel_struct
+{
+	const char* Name; // Name used to select the kernel
+	size_t (*FindByte)(const uint8_t*, size_t, uint8_t); // Offset of the first matching byte, length if there is none
+	size_t (*FindWord)(const uint8_t*, size_t, uint32_t); // Offset of the first matching 32 bit word (in steps of 4 bytes), length if there is none
+}kernel_struct;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+unsigned int firstBit(unsigned int);
+size_t findByteScalar(const uint8_t*, size_t, uint8_t);
+size_t findWordScalar(const uint8_t*, size_t, uint32_t);
+size_t findByteMemchr(const uint8_t*, size_t, uint8_t);
+#ifdef CURSOR_SSE2
+size_t findByteSSE2(const uint8_t*, size_t, uint8_t);
+size_t findWordSSE2(const uint8_t*, size_t, uint32_t);
+#endif
+#ifdef CURSOR_AVX2
+size_t findByteAVX2(const uint8_t*, size_t, uint8_t);
+size_t findWordAVX2(const uint8_t*, size_t, uint32_t);
+#endif
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+
+// Available scanning kernels, selected at runtime by name. Vector kernels are added at build time, the last one is the default
+const kernel_struct kernel[] =
+{
+	{ "scalar", findByteScalar, findWordScalar },
+	{ "memchr", findByteMemchr, findWordScalar },
+#ifdef CURSOR_SSE2
+	{ "sse2", findByteSSE2, findWordSSE2 },
+#endif
+#ifdef CURSOR_AVX2
+	{ "avx2", findByteAVX2, findWordAVX2 },
+#endif
+};
+
+unsigned int cursorKernel = sizeof(kernel) / sizeof(kernel_struct) - 1; // Selected kernel
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	cursor_open()
+*
+* - description: 	Makes the whole content of a file readable through a cursor. Files held by the in memory filesystem
+*					are read from there, all others are mapped into memory. Nothing is copied
+*
+* - parameter: 		complete file path; pointer to cursor
+*
+* - return value: 	error code
+******************************************************************
+*/
+int cursor_open(char* path, cursor_struct* cursor)
+{
+	uint8_t* Data = NULL;
+	size_t Size = 0;
+
+	cursor->Data = NULL;
+	cursor->Size = 0;
+	cursor->Position = 0;
+	cursor->Map.Data = NULL;
+	if (vfs_data(path, &Data, &Size) == 0)
+	{
+		cursor->Data = Data;
+		cursor->Size = Size;
+		return 0;
+	}
+	if (mapfile_open(path, &cursor->Map) == 0)
+	{
+		cursor->Data = cursor->Map.Data;
+		cursor->Size = cursor->Map.Size;
+		return 0;
+	}
+
+	// Empty files can not be mapped, but are valid
+	FILE* File = fopen(path, "rb");
+	if (File == NULL)
+	{
+		return -1;
+	}
+	fclose(File);
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_close()
+*
+* - description: 	Releases a cursor opened with cursor_open()
+*
+* - parameter: 		pointer to cursor
+*
+* - return value: 	-
+******************************************************************
+*/
+void cursor_close(cursor_struct* cursor)
+{
+	if (cursor->Map.Data != NULL)
+	{
+		mapfile_close(&cursor->Map);
+	}
+	cursor->Data = NULL;
+	cursor->Size = 0;
+	cursor->Position = 0;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_read()
+*
+* - description: 	Copies data at the read position and advances it. Like fread, a read at the end of the file
+*					copies only the remaining bytes
+*
+* - parameter: 		pointer to cursor; destination; number of bytes
+*
+* - return value: 	number of bytes copied
+******************************************************************
+*/
+size_t cursor_read(cursor_struct* cursor, void* destination, size_t length)
+{
+	size_t Remaining = cursor->Size - cursor->Position;
+	if (length > Remaining)
+	{
+		length = Remaining;
+	}
+	if (length > 0)
+	{
+		memcpy(destination, cursor->Data + cursor->Position, length);
+		cursor->Position += length;
+	}
+	return length;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_seek()
+*
+* - description: 	Moves the read position relative to its current value, limited to the start and end of the file
+*
+* - parameter: 		pointer to cursor; offset in bytes
+*
+* - return value: 	-
+******************************************************************
+*/
+void cursor_seek(cursor_struct* cursor, int64_t offset)
+{
+	if (offset < 0 && (uint64_t)-offset > cursor->Position)
+	{
+		cursor->Position = 0;
+	}
+	else if (offset > 0 && (uint64_t)offset > cursor->Size - cursor->Position)
+	{
+		cursor->Position = cursor->Size;
+	}
+	else
+	{
+		cursor->Position += offset;
+	}
+}
+
+/*
+******************************************************************
+* - function name:	cursor_skip_byte()
+*
+* - description: 	Moves the read position behind the next byte of the given value, or to the end of the file
+*
+* - parameter: 		pointer to cursor; value to find
+*
+* - return value: 	-
+******************************************************************
+*/
+void cursor_skip_byte(cursor_struct* cursor, uint8_t value)
+{
+	size_t Remaining = cursor->Size - cursor->Position;
+	size_t Offset = kernel[cursorKernel].FindByte(cursor->Data + cursor->Position, Remaining, value);
+	cursor->Position = (Offset < Remaining) ? cursor->Position + Offset + sizeof(uint8_t) : cursor->Size;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_skip_word()
+*
+* - description: 	Moves the read position behind the next 32 bit word of the given value, or to the end of the file.
+*					Words are compared in steps of 4 bytes starting at the read position
+*
+* - parameter: 		pointer to cursor; value to find
+*
+* - return value: 	-
+******************************************************************
+*/
+void cursor_skip_word(cursor_struct* cursor, uint32_t value)
+{
+	size_t Remaining = cursor->Size - cursor->Position;
+	size_t Offset = kernel[cursorKernel].FindWord(cursor->Data + cursor->Position, Remaining, value);
+	cursor->Position = (Offset < Remaining) ? cursor->Position + Offset + sizeof(uint32_t) : cursor->Size;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_kernel_name()
+*
+* - description: 	Returns the name of a scanning kernel, used to list all kernels
+*
+* - parameter: 		kernel number
+*
+* - return value: 	name or NULL if there is no such kernel
+******************************************************************
+*/
+const char* cursor_kernel_name(unsigned int number)
+{
+	if (number >= sizeof(kernel) / sizeof(kernel_struct))
+	{
+		return NULL;
+	}
+	return kernel[number].Name;
+}
+
+/*
+******************************************************************
+* - function name:	cursor_kernel_select()
+*
+* - description: 	Selects the kernel used to find block terminators
+*
+* - parameter: 		name of kernel
+*
+* - return value: 	0 if selected, -1 if the kernel is not available in this build
+******************************************************************
+*/
+int cursor_kernel_select(char* name)
+{
+	for (unsigned int i = 0; cursor_kernel_name(i) != NULL; i++)
+	{
+		if (strcmp(cursor_kernel_name(i), name) == 0)
+		{
+			cursorKernel = i;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	firstBit()
+*
+* - description: 	Returns the position of the lowest set bit
+*
+* - parameter: 		mask, must not be 0
+*
+* - return value: 	bit number
+******************************************************************
+*/
+unsigned int firstBit(unsigned int mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long Bit = 0;
+	_BitScanForward(&Bit, mask);
+	return (unsigned int)Bit;
+#else
+	unsigned int Bit = 0;
+	while ((mask & 1) == 0)
+	{
+		mask >>= 1;
+		Bit++;
+	}
+	return Bit;
+#endif
+}
+
+/*
+******************************************************************
+* - function name:	findByteScalar()
+*
+* - description: 	Finds a byte, one byte at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findByteScalar(const uint8_t* data, size_t length, uint8_t value)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		if (data[i] == value)
+		{
+			return i;
+		}
+	}
+	return length;
+}
+
+/*
+******************************************************************
+* - function name:	findWordScalar()
+*
+* - description: 	Finds a 32 bit word in steps of 4 bytes, one word at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findWordScalar(const uint8_t* data, size_t length, uint32_t value)
+{
+	uint32_t Word = 0;
+	for (size_t i = 0; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t))
+	{
+		memcpy(&Word, data + i, sizeof(uint32_t)); // The data is not aligned
+		if (Word == value)
+		{
+			return i;
+		}
+	}
+	return length;
+}
+
+/*
+******************************************************************
+* - function name:	findByteMemchr()
+*
+* - description: 	Finds a byte with the C library, which is vectorized on most platforms
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findByteMemchr(const uint8_t* data, size_t length, uint8_t value)
+{
+	const uint8_t* Match = (length > 0) ? memchr(data, value, length) : NULL;
+	return (Match != NULL) ? (size_t)(Match - data) : length;
+}
+
+#ifdef CURSOR_SSE2
+/*
+******************************************************************
+* - function name:	findByteSSE2()
+*
+* - description: 	Finds a byte, comparing 16 bytes at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findByteSSE2(const uint8_t* data, size_t length, uint8_t value)
+{
+	const __m128i Value = _mm_set1_epi8((char)value);
+	size_t i = 0;
+	for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+	{
+		unsigned int Mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), Value));
+		if (Mask != 0)
+		{
+			return i + firstBit(Mask);
+		}
+	}
+	return i + findByteScalar(data + i, length - i, value);
+}
+
+/*
+******************************************************************
+* - function name:	findWordSSE2()
+*
+* - description: 	Finds a 32 bit word in steps of 4 bytes, comparing 4 words at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findWordSSE2(const uint8_t* data, size_t length, uint32_t value)
+{
+	const __m128i Value = _mm_set1_epi32((int)value);
+	size_t i = 0;
+	for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+	{
+		unsigned int Mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(data + i)), Value));
+		if (Mask != 0)
+		{
+			return i + firstBit(Mask); // All 4 bits of a matching word are set, the lowest one is its offset
+		}
+	}
+	return i + findWordScalar(data + i, length - i, value);
+}
+#endif
+
+#ifdef CURSOR_AVX2
+/*
+******************************************************************
+* - function name:	findByteAVX2()
+*
+* - description: 	Finds a byte, comparing 32 bytes at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findByteAVX2(const uint8_t* data, size_t length, uint8_t value)
+{
+	const __m256i Value = _mm256_set1_epi8((char)value);
+	size_t i = 0;
+	for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+	{
+		unsigned int Mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), Value));
+		if (Mask != 0)
+		{
+			return i + firstBit(Mask);
+		}
+	}
+	return i + findByteSSE2(data + i, length - i, value);
+}
+
+/*
+******************************************************************
+* - function name:	findWordAVX2()
+*
+* - description: 	Finds a 32 bit word in steps of 4 bytes, comparing 8 words at a time
+*
+* - parameter: 		data; length of data; value to find
+*
+* - return value: 	offset of the first match, length if there is none
+******************************************************************
+*/
+size_t findWordAVX2(const uint8_t* data, size_t length, uint32_t value)
+{
+	const __m256i Value = _mm256_set1_epi32((int)value);
+	size_t i = 0;
+	for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+	{
+		unsigned int Mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(data + i)), Value));
+		if (Mask != 0)
+		{
+			return i + firstBit(Mask);
+		}
+	}
+	return i + findWordSSE2(data + i, length - i, value);
+}
+#endif
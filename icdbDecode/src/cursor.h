@@ -0,0 +1,62 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _CURSOR_H
+#define _CURSOR_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+#include "mapfile.h"	// Required for mapfile_struct
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct cursor_struct
+{
+	const uint8_t* Data;	// Start of the file content
+	size_t Size;			// Size of the file content
+	size_t Position;		// Read position, never beyond Size
+	mapfile_struct Map;		// Mapping of files not held by the in memory filesystem
+} cursor_struct;
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+extern unsigned int cursorKernel;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern int cursor_open(char*, cursor_struct*);
+extern void cursor_close(cursor_struct*);
+extern size_t cursor_read(cursor_struct*, void*, size_t);
+extern void cursor_seek(cursor_struct*, int64_t);
+extern void cursor_skip_byte(cursor_struct*, uint8_t);
+extern void cursor_skip_word(cursor_struct*, uint32_t);
+extern const char* cursor_kernel_name(unsigned int);
+extern int cursor_kernel_select(char*);
+
+#endif //_CURSOR_H
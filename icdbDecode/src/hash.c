@@ -0,0 +1,295 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "hash.h"
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcpy
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define HASH_MIN_SLOTS 16
+
+typedef struct hash_element_struct
+{
+	uint32_t hash;			// Hash of the key
+	unsigned int length;	// Length of the key
+	void* key;				// Copy of the key, NULL for empty slots
+	void* value;			// Value stored under this key
+}hash_element_struct;
+
+typedef struct hash_table_struct
+{
+	unsigned int slots;		// Number of slots, always a power of two
+	unsigned int elements;	// Number of used slots
+	hash_element_struct* element;
+}hash_table_struct;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+uint32_t hash_key(const void*, unsigned int);
+hash_element_struct* hash_find(hash_table_struct*, const void*, unsigned int, uint32_t);
+int hash_grow(hash_table_struct*);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	hash_init()
+*
+* - description: 	initializes a new hash table (open addressing)
+*
+* - parameter: 		expected number of elements
+*
+* - return value: 	pointer to hash table
+******************************************************************
+*/
+void* hash_init(unsigned int size)
+{
+	hash_table_struct* table = calloc(1, sizeof(hash_table_struct));
+	if (table != NULL)
+	{
+		table->slots = HASH_MIN_SLOTS;
+		while (table->slots < size * 2 && table->slots < 0x80000000) // Keep the table at most half full
+		{
+			table->slots <<= 1;
+		}
+		table->element = calloc(table->slots, sizeof(hash_element_struct));
+		if (table->element == NULL)
+		{
+			free(table);
+			table = NULL;
+		}
+	}
+	return table;
+}
+
+/*
+******************************************************************
+* - function name:	hash_insert()
+*
+* - description: 	stores a value under a key. The key is copied. An existing key is not replaced
+*
+* - parameter: 		pointer to hash table; pointer to key; length of key; value
+*
+* - return value: 	0 if inserted, 1 if the key already exists, -1 on error
+******************************************************************
+*/
+int hash_insert(void* head, const void* key, unsigned int length, void* value)
+{
+	hash_table_struct* table = head;
+	if (table == NULL)
+	{
+		return -1;
+	}
+	if ((table->elements + 1) * 2 > table->slots && hash_grow(table) != 0)
+	{
+		return -1;
+	}
+	uint32_t hash = hash_key(key, length);
+	hash_element_struct* element = hash_find(table, key, length, hash);
+	if (element->key != NULL)
+	{
+		return 1;
+	}
+	element->key = malloc(length > 0 ? length : 1);
+	if (element->key == NULL)
+	{
+		return -1;
+	}
+	memcpy(element->key, key, length);
+	element->hash = hash;
+	element->length = length;
+	element->value = value;
+	table->elements++;
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	hash_lookup()
+*
+* - description: 	returns the value stored under a key
+*
+* - parameter: 		pointer to hash table; pointer to key; length of key
+*
+* - return value: 	value or NULL if the key is not present
+******************************************************************
+*/
+void* hash_lookup(void* head, const void* key, unsigned int length)
+{
+	hash_table_struct* table = head;
+	if (table == NULL)
+	{
+		return NULL;
+	}
+	hash_element_struct* element = hash_find(table, key, length, hash_key(key, length));
+	return element->key != NULL ? element->value : NULL;
+}
+
+/*
+******************************************************************
+* - function name:	hash_elements()
+*
+* - description: 	returns the number of stored elements
+*
+* - parameter: 		pointer to hash table
+*
+* - return value: 	number of elements
+******************************************************************
+*/
+unsigned int hash_elements(void* head)
+{
+	hash_table_struct* table = head;
+	return table != NULL ? table->elements : 0;
+}
+
+/*
+******************************************************************
+* - function name:	hash_cleanup()
+*
+* - description: 	removes hash table. Values are not freed
+*
+* - parameter: 		pointer to hash table pointer
+*
+* - return value: 	-
+******************************************************************
+*/
+void hash_cleanup(void** head)
+{
+	hash_table_struct* table = *head;
+	if (table != NULL)
+	{
+		for (unsigned int i = 0; i < table->slots; i++)
+		{
+			free(table->element[i].key);
+		}
+		free(table->element);
+		free(table);
+	}
+	*head = NULL;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	hash_key()
+*
+* - description: 	FNV-1a hash of a key
+*
+* - parameter: 		pointer to key; length of key
+*
+* - return value: 	hash
+******************************************************************
+*/
+uint32_t hash_key(const void* key, unsigned int length)
+{
+	const uint8_t* data = key;
+	uint32_t hash = 2166136261u;
+	for (unsigned int i = 0; i < length; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+******************************************************************
+* - function name:	hash_find()
+*
+* - description: 	returns the slot holding a key, or the empty slot where it would be inserted
+*
+* - parameter: 		pointer to hash table; pointer to key; length of key; hash of key
+*
+* - return value: 	pointer to slot
+******************************************************************
+*/
+hash_element_struct* hash_find(hash_table_struct* table, const void* key, unsigned int length, uint32_t hash)
+{
+	unsigned int mask = table->slots - 1;
+	unsigned int slot = hash & mask;
+	while (table->element[slot].key != NULL)
+	{
+		if (table->element[slot].hash == hash && table->element[slot].length == length &&
+			memcmp(table->element[slot].key, key, length) == 0)
+		{
+			break;
+		}
+		slot = (slot + 1) & mask; // Linear probing
+	}
+	return &table->element[slot];
+}
+
+/*
+******************************************************************
+* - function name:	hash_grow()
+*
+* - description: 	doubles the number of slots and reinserts all elements
+*
+* - parameter: 		pointer to hash table
+*
+* - return value: 	error code
+******************************************************************
+*/
+int hash_grow(hash_table_struct* table)
+{
+	hash_table_struct newtable = { table->slots << 1, table->elements, NULL };
+	if (newtable.slots == 0)
+	{
+		return -1;
+	}
+	newtable.element = calloc(newtable.slots, sizeof(hash_element_struct));
+	if (newtable.element == NULL)
+	{
+		return -1;
+	}
+	for (unsigned int i = 0; i < table->slots; i++)
+	{
+		if (table->element[i].key != NULL)
+		{
+			unsigned int slot = table->element[i].hash & (newtable.slots - 1);
+			while (newtable.element[slot].key != NULL)
+			{
+				slot = (slot + 1) & (newtable.slots - 1);
+			}
+			newtable.element[slot] = table->element[i];
+		}
+	}
+	free(table->element);
+	*table = newtable;
+	return 0;
+}
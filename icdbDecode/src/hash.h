@@ -0,0 +1,31 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _HASH_H
+#define _HASH_H
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+void* hash_init(unsigned int);
+int hash_insert(void*, const void*, unsigned int, void*);
+void* hash_lookup(void*, const void*, unsigned int);
+unsigned int hash_elements(void*);
+void hash_cleanup(void**);
+
+
+#endif //_HASH_H
@@ -0,0 +1,269 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "inflater.h"
+#include <stdlib.h>		// Required for malloc
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for strcmp
+#include <zlib.h>		// Required for inflate
+#ifdef USE_LIBDEFLATE
+	#include <libdeflate.h> // Required for libdeflate_zlib_decompress_ex
+#endif
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define INFLATER_RATIO 4				// Expected compression ratio, used for the first output buffer
+#define INFLATER_MIN_OUTPUT 0x1000		// Smallest output buffer (4 KiB)
+#define INFLATER_MAX_OUTPUT 0x40000000	// Payloads inflating to more than this are considered damaged (1 GiB)
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct inflater_struct
+{
+	const char* Name; // Name used to select the backend
+	int (*OneShot)(const uint8_t*, size_t, uint8_t**, size_t*, size_t*); // Inflate a complete payload, NULL for streaming
+}inflater_struct;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+int growOutput(uint8_t**, size_t*);
+int zlibOneShot(const uint8_t*, size_t, uint8_t**, size_t*, size_t*);
+#ifdef USE_LIBDEFLATE
+int libdeflateOneShot(const uint8_t*, size_t, uint8_t**, size_t*, size_t*);
+#endif
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+unsigned int inflaterBackend = INFLATER_STREAM; // Selected backend
+
+// Available backends, selected at runtime by name. Optional ones are added at build time
+const inflater_struct inflater[] =
+{
+	{ "stream", NULL },
+	{ "zlib", zlibOneShot },
+#ifdef USE_LIBDEFLATE
+	{ "libdeflate", libdeflateOneShot },
+#endif
+};
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	inflater_name()
+*
+* - description: 	Returns the name of a backend, used to list all backends
+*
+* - parameter: 		backend number
+*
+* - return value: 	name or NULL if there is no such backend
+******************************************************************
+*/
+const char* inflater_name(unsigned int backend)
+{
+	if (backend >= sizeof(inflater) / sizeof(inflater_struct))
+	{
+		return NULL;
+	}
+	return inflater[backend].Name;
+}
+
+/*
+******************************************************************
+* - function name:	inflater_select()
+*
+* - description: 	Selects the backend used for compressed payloads
+*
+* - parameter: 		name of backend
+*
+* - return value: 	0 if selected, -1 if the backend is not available in this build
+******************************************************************
+*/
+int inflater_select(char* name)
+{
+	for (unsigned int i = 0; inflater_name(i) != NULL; i++)
+	{
+		if (strcmp(inflater_name(i), name) == 0)
+		{
+			inflaterBackend = i;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/*
+******************************************************************
+* - function name:	inflater_oneshot()
+*
+* - description: 	Inflates a complete zlib payload in one call with the selected backend.
+*					The inflated size is not stored in the database, so the output buffer grows until it fits
+*
+* - parameter: 		compressed data; length of compressed data; pointer to output (must be freed by the caller); pointer to output length
+*
+* - return value: 	0 on success, 1 if the backend has no one-shot path, -1 on damaged data
+******************************************************************
+*/
+int inflater_oneshot(const uint8_t* data, size_t length, uint8_t** output, size_t* outputLength)
+{
+	size_t Size = length * INFLATER_RATIO > INFLATER_MIN_OUTPUT ? length * INFLATER_RATIO : INFLATER_MIN_OUTPUT;
+
+	*output = NULL;
+	*outputLength = 0;
+	if (inflater[inflaterBackend].OneShot == NULL)
+	{
+		return 1;
+	}
+	*output = malloc(Size);
+	if (*output == NULL || inflater[inflaterBackend].OneShot(data, length, output, &Size, outputLength) != 0)
+	{
+		free(*output);
+		*output = NULL;
+		*outputLength = 0;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	growOutput()
+*
+* - description: 	Doubles the output buffer of a one-shot backend
+*
+* - parameter: 		pointer to output buffer; pointer to size of output buffer
+*
+* - return value: 	0 on success, -1 if out of memory or the output is implausibly large
+******************************************************************
+*/
+int growOutput(uint8_t** output, size_t* size)
+{
+	if (*size * 2 > INFLATER_MAX_OUTPUT)
+	{
+		return -1;
+	}
+	uint8_t* newOutput = realloc(*output, *size * 2);
+	if (newOutput == NULL)
+	{
+		return -1;
+	}
+	*output = newOutput;
+	*size *= 2;
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	zlibOneShot()
+*
+* - description: 	Inflates a complete payload with zlib straight into the output buffer.
+*					If the buffer is too small, it grows and inflation continues where it stopped
+*
+* - parameter: 		compressed data; length of compressed data; pointer to output buffer; pointer to size of output buffer; pointer to output length
+*
+* - return value: 	error code
+******************************************************************
+*/
+int zlibOneShot(const uint8_t* data, size_t length, uint8_t** output, size_t* size, size_t* outputLength)
+{
+	z_stream ZStream;
+	int Returnvalue = Z_OK;
+
+	memset(&ZStream, 0, sizeof(ZStream));
+	if (inflateInit(&ZStream) != Z_OK)
+	{
+		return -1;
+	}
+	ZStream.next_in = (unsigned char*)data;
+	ZStream.avail_in = (uInt)length;
+	while (Returnvalue == Z_OK)
+	{
+		if (ZStream.total_out == *size && growOutput(output, size) != 0)
+		{
+			break;
+		}
+		ZStream.next_out = *output + ZStream.total_out;
+		ZStream.avail_out = (uInt)(*size - ZStream.total_out);
+		Returnvalue = inflate(&ZStream, Z_FINISH);
+		if (Returnvalue == Z_BUF_ERROR && ZStream.avail_out == 0)
+		{
+			Returnvalue = Z_OK; // Output buffer full
+		}
+	}
+	*outputLength = ZStream.total_out;
+	inflateEnd(&ZStream);
+	return Returnvalue == Z_STREAM_END ? 0 : -1;
+}
+
+#ifdef USE_LIBDEFLATE
+/*
+******************************************************************
+* - function name:	libdeflateOneShot()
+*
+* - description: 	Inflates a complete payload with libdeflate. If the output buffer is too small,
+*					it grows and the payload is inflated again
+*
+* - parameter: 		compressed data; length of compressed data; pointer to output buffer; pointer to size of output buffer; pointer to output length
+*
+* - return value: 	error code
+******************************************************************
+*/
+int libdeflateOneShot(const uint8_t* data, size_t length, uint8_t** output, size_t* size, size_t* outputLength)
+{
+	size_t Input = 0;
+	enum libdeflate_result Returnvalue = LIBDEFLATE_INSUFFICIENT_SPACE;
+	struct libdeflate_decompressor* Decompressor = libdeflate_alloc_decompressor();
+	if (Decompressor == NULL)
+	{
+		return -1;
+	}
+	Returnvalue = libdeflate_zlib_decompress_ex(Decompressor, data, length, *output, *size, &Input, outputLength);
+	while (Returnvalue == LIBDEFLATE_INSUFFICIENT_SPACE && growOutput(output, size) == 0)
+	{
+		Returnvalue = libdeflate_zlib_decompress_ex(Decompressor, data, length, *output, *size, &Input, outputLength);
+	}
+	libdeflate_free_decompressor(Decompressor);
+	return Returnvalue == LIBDEFLATE_SUCCESS ? 0 : -1;
+}
+#endif
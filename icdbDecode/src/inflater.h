@@ -0,0 +1,51 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+#ifndef _INFLATER_H
+#define _INFLATER_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define INFLATER_STREAM 0		// Default, zlib inflate through a small buffer while the fragments are read
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+extern unsigned int inflaterBackend;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern const char* inflater_name(unsigned int);
+extern int inflater_select(char*);
+extern int inflater_oneshot(const uint8_t*, size_t, uint8_t**, size_t*);
+
+#endif //_INFLATER_H
@@ -254,12 +254,12 @@ void KiCadTextData(FILE* KiCadFile, textdata_struct textdata)
 *
 * - description: 	Prints strings to KiCad file
 *
-* - parameter: 		Pointer to KiCad file; String to print
+* - parameter: 		Pointer to KiCad file; String view to print (not zero terminated)
 *
 * - return value: 	-
 ******************************************************************
 */
-void KiCadPrintString(FILE* KiCadFile, string_struct String)
+void KiCadPrintString(FILE* KiCadFile, string_view_struct String)
 {
 	myPrint("\t[");
 	char Overbar = 0;
@@ -374,7 +374,7 @@ void KiCadUID(FILE* KiCadFile, uid_union pageUID, uid_union elementUID)
 * - return value: 	-
 ******************************************************************
 */
-void KiCadLabel(FILE* KiCadFile, uid_union UID, label_struct label, string_struct Name)
+void KiCadLabel(FILE* KiCadFile, uid_union UID, label_struct label, string_view_struct Name)
 {
 #ifdef B64Bit
 	if (label.IndexDxDNet.UID64 == 0 )
@@ -65,8 +65,8 @@ extern float BaseLineThickness;
 extern void KiCadProperty(FILE*, property_struct, uint8_t);
 extern void KiCadTextData(FILE*, textdata_struct);
 extern void KiCadUID(FILE*, uid_union, uid_union);
-extern void KiCadPrintString(FILE*, string_struct);
-extern void KiCadLabel(FILE*, uid_union, label_struct, string_struct);
+extern void KiCadPrintString(FILE*, string_view_struct);
+extern void KiCadLabel(FILE*, uid_union, label_struct, string_view_struct);
 extern void KiCadArc(FILE*, element_struct, uid_union, uint32_t);
 extern void KiCadCircle(FILE*, element_struct, uid_union, uint32_t);
 extern void KiCadRectangle(FILE*, element_struct, uid_union, uint32_t);
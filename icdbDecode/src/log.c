@@ -22,7 +22,20 @@
 #include "log.h"
 #include <stdio.h>		// Required for fprint, fopen, ...
 #include <stdarg.h>		// Required for va_list
+#include <stdlib.h>		// Required for realloc
 #include "common.h"		// Required for myfopen
+#include "workerpool.h"	// Required for THREAD_LOCAL
+
+#ifdef WIN32 // Building for Windows
+	#include <io.h>			// Required for _dup
+	#include <fcntl.h>		// Required for _O_BINARY
+	#define dup _dup
+	#define dup2 _dup2
+	#define fdopen _fdopen
+	#define fileno _fileno
+#else // Building for Unix
+	#include <unistd.h>		// Required for dup
+#endif
 
 
 
@@ -33,6 +46,7 @@
 */
 #define LOGFILE_NAME "\\icdbDecode.log"
 #define _CRT_SECURE_NO_DEPRECATE			// Disable insecure function warning in VisualStudio
+#define LOG_CAPTURE_CHUNK 4096				// Minimum growth of the capture buffer
 
 
 /*
@@ -43,6 +57,12 @@
 FILE* logFile = NULL;
 int quietMode = 0;
 
+// Per thread capture buffer. Used by worker threads to keep the log output in a deterministic order
+THREAD_LOCAL int logCapture = 0;
+THREAD_LOCAL char* logCaptureText = NULL;
+THREAD_LOCAL size_t logCaptureLength = 0;
+THREAD_LOCAL size_t logCaptureSize = 0;
+
 /*
 ******************************************************************
 * - function name:	myPrint()
@@ -56,8 +76,36 @@ int quietMode = 0;
 */
 void myPrint(const char* text, ...)
 {
-	// Print to terminal
 	va_list args;
+
+	// Capture output of worker threads
+	if (logCapture != 0)
+	{
+		va_start(args, text);
+		int length = vsnprintf(NULL, 0, text, args);
+		va_end(args);
+		if (length > 0)
+		{
+			if (logCaptureLength + length + 1 > logCaptureSize)
+			{
+				size_t newSize = logCaptureSize * 2 + length + LOG_CAPTURE_CHUNK;
+				char* newText = realloc(logCaptureText, newSize);
+				if (newText == NULL)
+				{
+					return;
+				}
+				logCaptureText = newText;
+				logCaptureSize = newSize;
+			}
+			va_start(args, text);
+			vsnprintf(logCaptureText + logCaptureLength, length + 1, text, args);
+			va_end(args);
+			logCaptureLength += length;
+		}
+		return;
+	}
+
+	// Print to terminal
 	va_start(args, text);
 	if (quietMode == 0)
 	{
@@ -117,5 +165,102 @@ void CloseLogfile(void)
 		quietMode = 0;
 		printf("\n%s Written\n", LOGFILE_NAME);
 		fclose(logFile);
+		logFile = NULL;
+	}
+}
+
+/*
+******************************************************************
+* - function name:	LogCaptureStart()
+*
+* - description: 	redirects all output of the calling thread into a buffer
+*
+* - parameter: 		-
+*
+* - return value: 	-
+******************************************************************
+*/
+void LogCaptureStart(void)
+{
+	logCapture = 1;
+	logCaptureText = NULL;
+	logCaptureLength = 0;
+	logCaptureSize = 0;
+}
+
+/*
+******************************************************************
+* - function name:	LogCaptureStop()
+*
+* - description: 	ends capturing and hands the captured text to the caller, who has to free it
+*
+* - parameter: 		pointer to text pointer
+*
+* - return value: 	length of captured text
+******************************************************************
+*/
+size_t LogCaptureStop(char** text)
+{
+	size_t length = logCaptureLength;
+	*text = logCaptureText;
+	logCapture = 0;
+	logCaptureText = NULL;
+	logCaptureLength = 0;
+	logCaptureSize = 0;
+	return length;
+}
+
+/*
+******************************************************************
+* - function name:	LogWrite()
+*
+* - description: 	prints previously captured text to logfile & to terminal, if quiet mode is deactivated
+*
+* - parameter: 		text to print; length of text
+*
+* - return value: 	-
+******************************************************************
+*/
+void LogWrite(const char* text, size_t length)
+{
+	if (text == NULL || length == 0)
+	{
+		return;
+	}
+	if (quietMode == 0)
+	{
+		fwrite(text, sizeof(char), length, stdout);
+		fflush(stdout);
+	}
+	if (logFile != 0)
+	{
+		fwrite(text, sizeof(char), length, logFile);
+	}
+}
+
+/*
+******************************************************************
+* - function name:	LogDetachStdout()
+*
+* - description: 	moves all terminal output of the program to stderr and hands the real stdout to the caller,
+*					so machine readable output (archive, listing) is not mixed with messages
+*
+* - parameter: 		-
+*
+* - return value: 	binary filepointer to stdout or NULL on error
+******************************************************************
+*/
+FILE* LogDetachStdout(void)
+{
+	fflush(stdout);
+	int Output = dup(fileno(stdout));
+	if (Output < 0)
+	{
+		return NULL;
 	}
-}
\ No newline at end of file
+	dup2(fileno(stderr), fileno(stdout));
+#ifdef WIN32 // Building for Windows
+	_setmode(Output, _O_BINARY);
+#endif
+	return fdopen(Output, "wb");
+}
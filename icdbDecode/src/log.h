@@ -16,6 +16,14 @@
 #ifndef _LOG_H
 #define _LOG_H
 
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stddef.h>		// Required for size_t
+#include <stdio.h>		// Required for FILE
+
 /*
 ******************************************************************
 * Global Variables
@@ -31,6 +39,10 @@ extern int quietMode;
 extern void myPrint(const char*, ...);
 void CreateLogfile(char*, int);
 void CloseLogfile(void);
+void LogCaptureStart(void);
+size_t LogCaptureStop(char**);
+void LogWrite(const char*, size_t);
+FILE* LogDetachStdout(void);
 
 
 #endif //_LOG_H
\ No newline at end of file
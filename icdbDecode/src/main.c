@@ -27,6 +27,13 @@
 #include "unpack.h"			// Required for UnpackIcdb
 #include "stringutil.h"		// Required for removeFilenameExtension
 #include "parser.h"			// Required for ParseIcdb
+#include "workerpool.h"		// Required for workerpool_cpus
+#include "vfs.h"			// Required for vfs_cleanup
+#include "batch.h"			// Required for batch_collect
+#include "common.h"			// Required for DIR_SEPARATOR
+#include "tar.h"			// Required for tar_open
+#include "inflater.h"		// Required for inflater_select
+#include "writer.h"		// Required for writer_select
 
 /*
 ******************************************************************
@@ -34,8 +41,18 @@
 ******************************************************************
 */
 #define DEFAULT_SOURCE "icdb.dat"
+#define BATCH_EXPORT_PATH "Export"			// KiCad files of each database in batch mode are stored below its destination
 #define _CRT_SECURE_NO_DEPRECATE			// Disable insecure function warning in VisualStudio
 
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+int convertDatabase(char*, uint32_t, char*, uint32_t);
+int runBatch(char*);
+int runList(char*, char*, int, FILE*);
+
 /*
 ******************************************************************
 * - function name:	main()
@@ -49,12 +66,60 @@
 */
 int main(int argc, char** argv)
 {
-	clock_t starttime = clock();
 	int error = 0;
 	uint32_t filepathLength = 0;
 	char* filepath = NULL;
 	uint32_t storepathLength = 0;
 	char* storepath = NULL;
+	char* batchpath = NULL;
+	int threadsGiven = 0;
+	int listFormat = 0;
+	FILE* listFile = NULL;
+
+	// The listing replaces stdout, so it is opened before anything is printed
+	for (int i = 0; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--list") == 0 && listFile == NULL)
+		{
+			listFormat = (i + 1 < argc && strcmp(argv[i + 1], "json") == 0) ? LIST_JSON : LIST_TSV;
+			listFile = LogDetachStdout();
+			if (listFile == NULL)
+			{
+				printf("Failed to open stdout for the listing!\n");
+				return -1;
+			}
+		}
+	}
+
+	// The checksum list replaces stdout as well, the log goes to stderr
+	for (int i = 0; i < argc && listFile == NULL; ++i)
+	{
+		if ((strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verify") == 0) && verifyFile == NULL)
+		{
+			verifyFile = LogDetachStdout();
+			if (verifyFile == NULL)
+			{
+				printf("Failed to open stdout for the checksum list!\n");
+				return -1;
+			}
+		}
+	}
+
+	// The archive may replace stdout, so it is opened before anything is printed
+	for (int i = 0; i < argc - 1 && listFile == NULL && verifyFile == NULL; ++i)
+	{
+		if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "-T") == 0) && tarFile == NULL)
+		{
+			tarFile = tar_open(argv[i + 1]);
+			if (tarFile == NULL)
+			{
+				printf("Failed to create archive [%s]!\n", argv[i + 1]);
+				return -1;
+			}
+			printf("Using archive: \t\t[%s]\n", argv[i + 1]);
+			noWriteFiles = 1; // Files only go into the archive
+		}
+	}
 
 	// Check parameter
 	for (int i = 0; i < argc; ++i)
@@ -81,14 +146,66 @@ int main(int argc, char** argv)
 		{
 			quietMode = 1;
 		}
-		else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "-L") == 0) && noLongLongFiles == 0)
+		else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "-L") == 0) && noLongLongFiles == 0 && dedupeFiles == 0)
 		{
 			linkLongLongFiles = 1;
 		}
-		else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-N") == 0) && linkLongLongFiles == 0)
+		else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-N") == 0) && linkLongLongFiles == 0 && dedupeFiles == 0)
 		{	
 			noLongLongFiles = 1;
 		}
+		else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-R") == 0) && linkLongLongFiles == 0 && noLongLongFiles == 0)
+		{
+			dedupeFiles = 1;
+		}
+		else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "-M") == 0)
+		{
+			noWriteFiles = 1;
+		}
+		else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "-J") == 0) && argc > i + 1)
+		{	// Worker threads
+			int threads = atoi(argv[i + 1]);
+			threadsGiven = 1;
+			if (threads <= 0) // Use all processors
+			{
+				numThreads = workerpool_cpus();
+			}
+			else
+			{
+				numThreads = threads;
+			}
+		}
+		else if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "-I") == 0 || strcmp(argv[i], "--include") == 0) && argc > i + 1)
+		{	// Include pattern, may be given multiple times
+			addIncludePattern(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "-U") == 0)
+		{
+			updateFiles = 1;
+		}
+		else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verify") == 0)
+		{
+			verifyFiles = 1;
+		}
+		else if ((strcmp(argv[i], "-z") == 0 || strcmp(argv[i], "-Z") == 0) && argc > i + 1)
+		{	// Decompression backend
+			if (inflater_select(argv[i + 1]) != 0)
+			{
+				printf("Decompression backend [%s] is not available, using [%s].\n", argv[i + 1], inflater_name(inflaterBackend));
+			}
+		}
+		else if ((strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "-W") == 0) && argc > i + 1)
+		{	// Write backend
+			if (writer_select(argv[i + 1]) != 0)
+			{
+				printf("Write backend [%s] is not available, using [%s].\n", argv[i + 1], writer_name(writerBackend));
+			}
+		}
+		else if ((strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "-B") == 0) && argc > i + 1)
+		{	// Batch of databases
+			batchpath = argv[i + 1];
+			printf("Using batch: \t\t[%s]\n", batchpath);
+		}
 		else if ((strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "-H") == 0))
 		{
 			// Print Help
@@ -100,12 +217,78 @@ int main(int argc, char** argv)
 			printf("Use parameter -c to not decompress files\n");
 			printf("Use parameter -l to link double files\n");
 			printf("Use parameter -n to skip double files\n");
+			printf("Use parameter -r to write double files as reflink or hardlink of the first copy\n");
 			printf("Use parameter -q for quiet mode (faster)\n");
+			printf("Use parameter -m to keep extracted files in memory only (nothing is written to disk)\n");
+			printf("Use parameter -t to write all extracted files into a single tar archive (- for stdout)\n");
+			printf("Use parameter -j to specify the number of extraction threads (0 = all processors)\n");
+			printf("Use parameter -u to only write files changed since the last extraction\n");
+			printf("Use parameter -b to convert all databases of a directory, or listed in a file (one path per line)\n");
+			printf("Use parameter -i to only extract entries matching a pattern, e.g. -i \"s1/cdbblks/*\" (can be repeated)\n");
+			printf("Use parameter -v to only verify all entries and print their CRC-32 (nothing is extracted)\n");
+			printf("Use parameter --list [tsv|json] to only print the header and directory of the database (no payload is read)\n");
+			printf("Use parameter -z to select the decompression backend:");
+			for (unsigned int j = 0; inflater_name(j) != NULL; j++)
+			{
+				printf(" %s", inflater_name(j));
+			}
+			printf(" (default %s)\n", inflater_name(INFLATER_STREAM));
+			printf("Use parameter -w to select the write backend:");
+			for (unsigned int j = 0; writer_name(j) != NULL; j++)
+			{
+				printf(" %s", writer_name(j));
+			}
+			printf(" (default %s)\n", writer_name(WRITER_STDIO));
 			printf("Use parameter -h for this help\n\n");
 			printf("This project uses the Zlib library (https://www.zlib.net/) for decompression.\n\n");
 			printf("********************************\n\n");
 		}
 	}
+	if (verifyFiles == 1)
+	{
+		// Every payload is read and nothing is written
+		noWriteFiles = 1;
+		linkLongLongFiles = 0;
+		noLongLongFiles = 0;
+		dedupeFiles = 0;
+		if (threadsGiven == 0)
+		{
+			numThreads = workerpool_cpus();
+		}
+	}
+	if (listFile != NULL)
+	{
+		// Only the directory is read, no log file or folder is created
+		error = runList(batchpath, filepathLength != 0 ? filepath : DEFAULT_SOURCE, listFormat, listFile);
+		fclose(listFile);
+		free(filepath);
+		free(storepath);
+		freeIncludePatterns();
+		return error;
+	}
+	if (batchpath != NULL)
+	{
+		if (filepathLength != 0 || storepathLength != 0)
+		{
+			printf("Source and destination are ignored in batch mode.\n");
+		}
+		if (tarFile != NULL)
+		{
+			printf("Archive output is not supported in batch mode.\n");
+			tar_close(tarFile);
+			tarFile = NULL;
+			noWriteFiles = 0;
+		}
+		free(filepath);
+		free(storepath);
+		error = runBatch(batchpath);
+		if (verifyFile != NULL)
+		{
+			fclose(verifyFile);
+		}
+		freeIncludePatterns();
+		return error;
+	}
 	if (filepathLength == 0) // No argument specified
 	{
 		printf("No source specified. Using default path.\n");
@@ -126,7 +309,41 @@ int main(int argc, char** argv)
 			memcpy(storepath, filepath, storepathLength);
 		}
 	}
-	
+
+	error = convertDatabase(filepath, filepathLength, storepath, storepathLength);
+	if (tarFile != NULL && tar_close(tarFile) != 0)
+	{
+		printf("Failed to write archive!\n");
+		error = -1;
+	}
+	if (verifyFile != NULL)
+	{
+		fclose(verifyFile);
+	}
+	free(filepath);
+	free(storepath);
+	freeIncludePatterns();
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	convertDatabase()
+*
+* - description: 	Extracts and parses a single database. Everything kept between the steps
+*					(log file, in memory filesystem, parser data) is released again before returning
+*
+* - parameter: 		source path; length of source path; destination path; length of destination path
+*
+* - return value: 	error code
+******************************************************************
+*/
+int convertDatabase(char* filepath, uint32_t filepathLength, char* storepath, uint32_t storepathLength)
+{
+	clock_t starttime = clock();
+	int error = 0;
+	int quietModeUser = quietMode;
+
 	// Remove .dat ending from database
 	removeFilenameExtension(storepath, &storepathLength);
 
@@ -151,6 +368,42 @@ int main(int argc, char** argv)
 	{	
 		myPrint("Skipping double files\n");
 	}
+	if (dedupeFiles)
+	{
+		myPrint("Deduplicating double files\n");
+	}
+	if (verifyFiles)
+	{
+		myPrint("Verifying files only\n");
+	}
+	else if (tarFile != NULL)
+	{
+		myPrint("Writing extracted files into an archive\n");
+	}
+	else if (noWriteFiles)
+	{
+		myPrint("Extracted files are kept in memory only\n");
+	}
+	if (updateFiles)
+	{
+		myPrint("Only writing changed files\n");
+	}
+	if (numThreads > 1)
+	{
+		myPrint("Using %d extraction threads\n", numThreads);
+	}
+	if (inflaterBackend != INFLATER_STREAM)
+	{
+		myPrint("Using [%s] decompression backend\n", inflater_name(inflaterBackend));
+	}
+	if (writerBackend != WRITER_STDIO)
+	{
+		myPrint("Using [%s] write backend\n", writer_name(writerBackend));
+	}
+	for (unsigned int i = 0; i < includePatternCnt; i++)
+	{
+		myPrint("Including entries matching [%s]\n", includePattern[i]);
+	}
 	myPrint("\n");
 	quietMode = quietModeTemp;
 
@@ -159,11 +412,14 @@ int main(int argc, char** argv)
 		printf("Working, please wait...\n\n");
 	}
 
+	// The parser reads the extracted files from memory instead of disk
+	memoryFiles = (nontDecompress == 0 && noLongLongFiles == 0 && verifyFiles == 0);
+
 	error = UnpackIcdb(filepath, filepathLength, storepath, storepathLength);
 	if (error == 0)
 	{
 		myPrint("\n\n************************ Parsing Database ************************\n\n");
-		if (nontDecompress == 0 && noLongLongFiles == 0)
+		if (memoryFiles == 1)
 		{
 			error = ParseIcdb(storepath, storepathLength);
 		}
@@ -172,8 +428,163 @@ int main(int argc, char** argv)
 			myPrint("Parsing disabled!\n\n");
 		}
 	}
+	vfs_cleanup();
 	quietMode = 0;
 	myPrint("Finnish after %fs\n", (float)(clock() - starttime)/(float) CLOCKS_PER_SEC);
-	void CloseLogfile(void);
+	CloseLogfile();
+	quietMode = quietModeUser;
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	runBatch()
+*
+* - description: 	Converts all databases of a batch one after another in this process.
+*					All databases share one pool of extraction threads. Each database is extracted next to itself,
+*					its log and KiCad files are stored in the extracted folder. A summary is printed at the end
+*
+* - parameter: 		directory or list file
+*
+* - return value: 	error code, 0 if all databases were converted
+******************************************************************
+*/
+int runBatch(char* batchpath)
+{
+	char** database = NULL;
+	unsigned int databaseCnt = 0;
+	unsigned int failed = 0;
+	int* result = NULL;
+	unsigned int* entries = NULL;
+	float* duration = NULL;
+	char* defaultExportPath = exportPath;
+	uint32_t defaultExportPathLength = exportPathLength;
+
+	if (batch_collect(batchpath, &database, &databaseCnt) != 0 || databaseCnt == 0)
+	{
+		printf("No databases found in [%s]!\n", batchpath);
+		batch_cleanup(&database, &databaseCnt);
+		return -1;
+	}
+	result = calloc(databaseCnt, sizeof(int));
+	entries = calloc(databaseCnt, sizeof(unsigned int));
+	duration = calloc(databaseCnt, sizeof(float));
+	if (result == NULL || entries == NULL || duration == NULL)
+	{
+		printf("Out of memory!\n");
+		free(result);
+		free(entries);
+		free(duration);
+		batch_cleanup(&database, &databaseCnt);
+		return -1;
+	}
+	printf("%d database(s) found.\n\n", databaseCnt);
+
+	workerpool_start(numThreads);
+	for (unsigned int i = 0; i < databaseCnt; i++)
+	{
+		clock_t starttime = clock();
+		uint32_t filepathLength = (uint32_t)strlen(database[i]) + 1;
+		uint32_t storepathLength = filepathLength;
+		char* storepath = calloc(storepathLength, sizeof(char));
+
+		printf("************** Database %d of %d: [%s] **************\n", i + 1, databaseCnt, database[i]);
+		if (storepath == NULL)
+		{
+			result[i] = -1;
+			failed++;
+			continue;
+		}
+		memcpy(storepath, database[i], storepathLength);
+
+		// Keep the KiCad files of each database apart
+		removeFilenameExtension(storepath, &storepathLength);
+		exportPathLength = assemblePath(&exportPath, storepath, storepathLength, BATCH_EXPORT_PATH, sizeof(BATCH_EXPORT_PATH), DIR_SEPARATOR) + 1;
+
+		result[i] = convertDatabase(database[i], filepathLength, storepath, storepathLength);
+		entries[i] = numExtractedFiles;
+		duration[i] = (float)(clock() - starttime) / (float)CLOCKS_PER_SEC;
+		if (result[i] != 0)
+		{
+			failed++;
+		}
+		free(exportPath);
+		exportPath = defaultExportPath;
+		exportPathLength = defaultExportPathLength;
+		free(storepath);
+		printf("\n");
+	}
+	workerpool_stop();
+
+	// Summary
+	printf("************************* Batch Summary **************************\n");
+	printf("Result\tEntries\tTime\t\tDatabase\n");
+	for (unsigned int i = 0; i < databaseCnt; i++)
+	{
+		printf("%s\t%d\t%fs\t%s\n", result[i] == 0 ? "OK" : "FAILED", entries[i], duration[i], database[i]);
+	}
+	printf("%d of %d database(s) converted.\n", databaseCnt - failed, databaseCnt);
+
+	free(result);
+	free(entries);
+	free(duration);
+	batch_cleanup(&database, &databaseCnt);
+	return failed != 0;
+}
+
+/*
+******************************************************************
+* - function name:	runList()
+*
+* - description: 	Lists the header and directory of a single database, or of all databases of a batch.
+*					JSON listings of a batch are combined into one array
+*
+* - parameter: 		directory or list file, NULL for a single database; source path; LIST_TSV or LIST_JSON; output stream
+*
+* - return value: 	error code, 0 if all databases were listed
+******************************************************************
+*/
+int runList(char* batchpath, char* filepath, int format, FILE* output)
+{
+	char** database = &filepath;
+	unsigned int databaseCnt = 1;
+	unsigned int listed = 0;
+	int error = 0;
+
+	if (batchpath != NULL && (batch_collect(batchpath, &database, &databaseCnt) != 0 || databaseCnt == 0))
+	{
+		printf("No databases found in [%s]!\n", batchpath);
+		batch_cleanup(&database, &databaseCnt);
+		return -1;
+	}
+	if (batchpath != NULL && format == LIST_JSON)
+	{
+		fputs("[\n", output);
+	}
+	for (unsigned int i = 0; i < databaseCnt; i++)
+	{
+		char* prefix = (listed > 0) ? (format == LIST_JSON ? ",\n" : "\n") : "";
+		int result = ListIcdb(database[i], format, prefix, output);
+		if (result < 0)
+		{
+			printf("Failed to list [%s]!\n", database[i]);
+			error = -1;
+			continue;
+		}
+		if (result > 0)
+		{
+			printf("Header or directory of [%s] is damaged, the listing might be incomplete!\n", database[i]);
+			error = -1;
+		}
+		listed++;
+	}
+	if (batchpath != NULL && format == LIST_JSON)
+	{
+		fputs("]\n", output);
+	}
+	if (batchpath != NULL)
+	{
+		batch_cleanup(&database, &databaseCnt);
+	}
 	return error;
 }
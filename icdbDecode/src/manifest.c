@@ -0,0 +1,249 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "manifest.h"
+#include <stdio.h>		// Required for fopen, fprintf
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcmp
+#include "hash.h"		// Required for hash_init
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define MANIFEST_VERSION 1			// Increment if the format changes
+#define MANIFEST_GUID_SIZE 24		// Size of a file GUID
+#define MANIFEST_LINE_LENGTH 512	// Longest line of a manifest
+#define MANIFEST_EXPECTED_FILES 1024 // Initial size of the name index
+#define _CRT_SECURE_NO_DEPRECATE	// Disable insecure function warning in VisualStudio
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct manifest_entry_struct
+{
+	uint8_t GUID[MANIFEST_GUID_SIZE]; // File GUID
+	uint32_t Size; // Payload size
+	uint32_t Address; // Payload address
+}manifest_entry_struct;
+
+typedef struct manifest_struct
+{
+	void* Index; // Name -> manifest_entry_struct
+	manifest_entry_struct* Entry; // All entries
+}manifest_struct;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	manifest_load()
+*
+* - description: 	Loads the manifest of a previous extraction.
+*					A manifest written with a different output mode (e.g. without decompression) is not used
+*
+* - parameter: 		manifest path; output mode; pointer to opening counter stored in the manifest
+*
+* - return value: 	manifest handle or NULL if there is no usable manifest
+******************************************************************
+*/
+void* manifest_load(char* path, int mode, uint32_t* openingCounter)
+{
+	char Line[MANIFEST_LINE_LENGTH];
+	unsigned int version = 0;
+	int fileMode = 0;
+	unsigned int entries = 0;
+	unsigned int count = 0;
+	FILE* manifestFile = fopen(path, "r");
+	if (manifestFile == NULL)
+	{
+		return NULL;
+	}
+	if (fgets(Line, sizeof(Line), manifestFile) == NULL ||
+		sscanf(Line, "icdbDecode manifest %u %d %u %u", &version, &fileMode, openingCounter, &entries) != 4 ||
+		version != MANIFEST_VERSION || fileMode != mode)
+	{
+		fclose(manifestFile);
+		return NULL;
+	}
+
+	manifest_struct* manifest = calloc(1, sizeof(manifest_struct));
+	if (manifest == NULL)
+	{
+		fclose(manifestFile);
+		return NULL;
+	}
+	manifest->Index = hash_init(entries > 0 ? entries : MANIFEST_EXPECTED_FILES);
+	manifest->Entry = calloc(entries + 1, sizeof(manifest_entry_struct));
+	if (manifest->Index == NULL || manifest->Entry == NULL)
+	{
+		fclose(manifestFile);
+		manifest_cleanup((void**)&manifest);
+		return NULL;
+	}
+
+	// One line per file: GUID, size, address, name
+	while (count < entries && fgets(Line, sizeof(Line), manifestFile) != NULL)
+	{
+		manifest_entry_struct* entry = &manifest->Entry[count];
+		unsigned int position = 0;
+		int nameStart = 0;
+		for (unsigned int i = 0; i < MANIFEST_GUID_SIZE; i++)
+		{
+			unsigned int value = 0;
+			if (sscanf(Line + position, "%2x", &value) != 1)
+			{
+				break;
+			}
+			entry->GUID[i] = (uint8_t)value;
+			position += 2;
+		}
+		if (sscanf(Line + position, "\t%u\t%u\t%n", &entry->Size, &entry->Address, &nameStart) != 2 || nameStart == 0)
+		{
+			continue; // Damaged line, the file is extracted again
+		}
+		char* name = Line + position + nameStart;
+		size_t nameLength = strcspn(name, "\r\n");
+		if (hash_insert(manifest->Index, name, (unsigned int)nameLength, entry) == 0)
+		{
+			count++;
+		}
+	}
+	fclose(manifestFile);
+	return manifest;
+}
+
+/*
+******************************************************************
+* - function name:	manifest_unchanged()
+*
+* - description: 	Checks if a file is listed in the manifest with the same GUID, size and payload address
+*
+* - parameter: 		manifest handle; name; length of name; GUID; payload size; payload address
+*
+* - return value: 	1 if unchanged, 0 otherwise
+******************************************************************
+*/
+int manifest_unchanged(void* head, char* name, unsigned int nameLength, uint8_t* GUID, uint32_t size, uint32_t address)
+{
+	manifest_struct* manifest = head;
+	if (manifest == NULL)
+	{
+		return 0;
+	}
+	manifest_entry_struct* entry = hash_lookup(manifest->Index, name, nameLength);
+	return entry != NULL && entry->Size == size && entry->Address == address &&
+		memcmp(entry->GUID, GUID, MANIFEST_GUID_SIZE) == 0;
+}
+
+/*
+******************************************************************
+* - function name:	manifest_cleanup()
+*
+* - description: 	Releases a manifest loaded with manifest_load()
+*
+* - parameter: 		pointer to manifest handle
+*
+* - return value: 	-
+******************************************************************
+*/
+void manifest_cleanup(void** head)
+{
+	manifest_struct* manifest = *head;
+	if (manifest != NULL)
+	{
+		hash_cleanup(&manifest->Index);
+		free(manifest->Entry);
+		free(manifest);
+	}
+	*head = NULL;
+}
+
+/*
+******************************************************************
+* - function name:	manifest_create()
+*
+* - description: 	Starts writing a new manifest
+*
+* - parameter: 		manifest path; output mode; opening counter of the database; number of entries that will be added
+*
+* - return value: 	filepointer or NULL on error
+******************************************************************
+*/
+FILE* manifest_create(char* path, int mode, uint32_t openingCounter, unsigned int entries)
+{
+	FILE* manifestFile = fopen(path, "w");
+	if (manifestFile != NULL)
+	{
+		fprintf(manifestFile, "icdbDecode manifest %u %d %u %u\n", MANIFEST_VERSION, mode, openingCounter, entries);
+	}
+	return manifestFile;
+}
+
+/*
+******************************************************************
+* - function name:	manifest_add()
+*
+* - description: 	Adds a file to a manifest
+*
+* - parameter: 		filepointer; name; length of name; GUID; payload size; payload address
+*
+* - return value: 	-
+******************************************************************
+*/
+void manifest_add(FILE* manifestFile, char* name, unsigned int nameLength, uint8_t* GUID, uint32_t size, uint32_t address)
+{
+	for (unsigned int i = 0; i < MANIFEST_GUID_SIZE; i++)
+	{
+		fprintf(manifestFile, "%02x", GUID[i]);
+	}
+	fprintf(manifestFile, "\t%u\t%u\t%.*s\n", size, address, nameLength, name);
+}
+
+/*
+******************************************************************
+* - function name:	manifest_close()
+*
+* - description: 	Finishes a manifest and closes it
+*
+* - parameter: 		filepointer
+*
+* - return value: 	error code
+******************************************************************
+*/
+int manifest_close(FILE* manifestFile)
+{
+	int error = ferror(manifestFile);
+	if (fclose(manifestFile) != 0)
+	{
+		error = -1;
+	}
+	return error;
+}
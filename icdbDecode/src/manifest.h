@@ -0,0 +1,47 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+#ifndef _MANIFEST_H
+#define _MANIFEST_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for file type
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define MANIFEST_NAME "\\icdbDecode.manifest" // Stored in the root of the extracted tree
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern void* manifest_load(char*, int, uint32_t*);
+extern int manifest_unchanged(void*, char*, unsigned int, uint8_t*, uint32_t, uint32_t);
+extern void manifest_cleanup(void**);
+extern FILE* manifest_create(char*, int, uint32_t, unsigned int);
+extern void manifest_add(FILE*, char*, unsigned int, uint8_t*, uint32_t, uint32_t);
+extern int manifest_close(FILE*);
+
+#endif //_MANIFEST_H
@@ -0,0 +1,287 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#ifdef __linux__
+	#define _GNU_SOURCE		// Required for copy_file_range
+#endif
+#define _FILE_OFFSET_BITS 64	// 64 bit off_t, so fstat reports the real size of large files instead of failing
+#include "mapfile.h"
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+#ifdef WIN32 // Building for Windows
+	#include <windows.h>	// Required for CreateFileMapping, MapViewOfFile
+#else // Building for Unix
+	#include <fcntl.h>		// Required for open
+	#include <unistd.h>		// Required for close, sysconf
+	#include <sys/mman.h>	// Required for mmap
+	#include <sys/stat.h>	// Required for fstat
+	#include <errno.h>		// Required for errno
+	#ifdef __linux__
+		#include <sys/sendfile.h>	// Required for sendfile
+	#endif
+#endif
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	mapfile_open()
+*
+* - description: 	Maps a whole file into memory.
+*					The mapping is read only, nothing is charged to the commit limit for it.
+*					The file is mapped as a single view, so it has to fit into the address space.
+*					32 bit builds can not map databases larger than roughly 1-2 GB, use a 64 bit build for them
+*
+* - parameter: 		filepath string; pointer to map structure
+*
+* - return value: 	0 on success, MAPFILE_TOO_LARGE if the view does not fit into the address space, -1 on other errors
+******************************************************************
+*/
+int mapfile_open(char* path, mapfile_struct* map)
+{
+	map->Data = NULL;
+	map->Size = 0;
+	map->File = NULL;
+	map->Mapping = NULL;
+	map->Descriptor = -1;
+
+#ifdef WIN32 // Building for Windows
+	LARGE_INTEGER FileSize;
+	HANDLE File = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return -1;
+	}
+	if (GetFileSizeEx(File, &FileSize) == 0 || FileSize.QuadPart == 0)
+	{
+		CloseHandle(File);
+		return -1;
+	}
+	if ((uint64_t)FileSize.QuadPart > SIZE_MAX)
+	{
+		CloseHandle(File);
+		return MAPFILE_TOO_LARGE;
+	}
+	HANDLE Mapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (Mapping == NULL)
+	{
+		CloseHandle(File);
+		return -1;
+	}
+	map->Data = (uint8_t*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (map->Data == NULL)
+	{
+		DWORD Error = GetLastError();
+		CloseHandle(Mapping);
+		CloseHandle(File);
+		return Error == ERROR_NOT_ENOUGH_MEMORY ? MAPFILE_TOO_LARGE : -1;
+	}
+	map->Size = (size_t)FileSize.QuadPart;
+	map->File = File;
+	map->Mapping = Mapping;
+#else // Building for Unix
+	struct stat FileStat;
+	int File = open(path, O_RDONLY);
+	if (File < 0)
+	{
+		return -1;
+	}
+	if (fstat(File, &FileStat) != 0 || FileStat.st_size == 0)
+	{
+		close(File);
+		return -1;
+	}
+	if ((uint64_t)FileStat.st_size > SIZE_MAX)
+	{
+		close(File);
+		return MAPFILE_TOO_LARGE;
+	}
+	void* Data = mmap(NULL, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+	if (Data == MAP_FAILED)
+	{
+		int Error = errno;
+		close(File);
+		return Error == ENOMEM ? MAPFILE_TOO_LARGE : -1;
+	}
+	map->Data = (uint8_t*)Data;
+	map->Size = (size_t)FileStat.st_size;
+	map->Descriptor = File; // Kept open for mapfile_copy()
+#endif
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	mapfile_close()
+*
+* - description: 	Releases a mapping created with mapfile_open()
+*
+* - parameter: 		pointer to map structure
+*
+* - return value: 	-
+******************************************************************
+*/
+void mapfile_close(mapfile_struct* map)
+{
+	if (map->Data != NULL)
+	{
+#ifdef WIN32 // Building for Windows
+		UnmapViewOfFile(map->Data);
+		CloseHandle((HANDLE)map->Mapping);
+		CloseHandle((HANDLE)map->File);
+#else // Building for Unix
+		munmap(map->Data, map->Size);
+		close(map->Descriptor);
+#endif
+	}
+	map->Data = NULL;
+	map->Size = 0;
+	map->File = NULL;
+	map->Mapping = NULL;
+	map->Descriptor = -1;
+}
+
+/*
+******************************************************************
+* - function name:	mapfile_address()
+*
+* - description: 	Returns a pointer into the mapping, if the requested range is inside the file
+*
+* - parameter: 		pointer to map structure; offset into file; number of bytes required
+*
+* - return value: 	pointer to data or NULL if out of range
+******************************************************************
+*/
+void* mapfile_address(mapfile_struct* map, size_t offset, size_t length)
+{
+	if (map->Data == NULL || offset > map->Size || length > map->Size - offset)
+	{
+		return NULL;
+	}
+	return map->Data + offset;
+}
+
+/*
+******************************************************************
+* - function name:	mapfile_prefetch()
+*
+* - description: 	Asks the operating system to start reading a range of the mapping in the background.
+*					Ranges outside the file are ignored
+*
+* - parameter: 		pointer to map structure; offset into file; number of bytes
+*
+* - return value: 	-
+******************************************************************
+*/
+void mapfile_prefetch(mapfile_struct* map, size_t offset, size_t length)
+{
+	if (map->Data == NULL || offset >= map->Size || length == 0)
+	{
+		return;
+	}
+	if (length > map->Size - offset)
+	{
+		length = map->Size - offset;
+	}
+#ifdef WIN32 // Building for Windows
+	#if _WIN32_WINNT >= 0x0602 // PrefetchVirtualMemory requires Windows 8
+		WIN32_MEMORY_RANGE_ENTRY Range;
+		Range.VirtualAddress = map->Data + offset;
+		Range.NumberOfBytes = length;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+	#endif
+#else // Building for Unix
+	// madvise needs a page aligned start
+	size_t PageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t Start = offset - (offset % PageSize);
+	madvise(map->Data + Start, length + (offset - Start), MADV_WILLNEED);
+#endif
+}
+
+/*
+******************************************************************
+* - function name:	mapfile_copy()
+*
+* - description: 	Copies a range of the file to the end of a destination file inside the kernel
+*					(copy_file_range, or sendfile on older kernels), so the data never passes through user space.
+*					Pending output of the destination file is flushed first. Safe to call from multiple threads
+*
+* - parameter: 		pointer to map structure; offset into file; number of bytes; destination file
+*
+* - return value: 	0 if everything was copied, -1 if nothing was copied and the caller has to write the data itself
+******************************************************************
+*/
+int mapfile_copy(mapfile_struct* map, size_t offset, size_t length, FILE* destFile)
+{
+#if defined(__linux__)
+	if (map->Descriptor < 0 || offset > map->Size || length > map->Size - offset || fflush(destFile) != 0)
+	{
+		return -1;
+	}
+	int Destination = fileno(destFile);
+	off_t Offset = (off_t)offset;
+	size_t copied = 0;
+	int useSendfile = 0;
+	while (copied < length)
+	{
+		ssize_t result = -1;
+		if (useSendfile == 0)
+		{
+			result = copy_file_range(map->Descriptor, &Offset, Destination, NULL, length - copied, 0);
+			if (result < 0 && copied == 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+			{
+				useSendfile = 1; // Not supported for this pair of files
+				continue;
+			}
+		}
+		else
+		{
+			result = sendfile(Destination, map->Descriptor, &Offset, length - copied);
+		}
+		if (result <= 0)
+		{
+			if (copied == 0)
+			{
+				return -1;
+			}
+			// Part of the data is out already, finish through the mapping
+			if (fwrite(map->Data + offset + copied, sizeof(uint8_t), length - copied, destFile) != length - copied)
+			{
+				return -1;
+			}
+			return 0;
+		}
+		copied += (size_t)result;
+	}
+	return 0;
+#else
+	(void)map;
+	(void)offset;
+	(void)length;
+	(void)destFile;
+	return -1; // No kernel copy available
+#endif
+}
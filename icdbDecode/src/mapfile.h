@@ -0,0 +1,60 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _MAPFILE_H
+#define _MAPFILE_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+#include <stdio.h>		// Required for file type
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define MAPFILE_TOO_LARGE -2	// The file does not fit into the address space of the process
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct mapfile_struct
+{
+	uint8_t* Data;		// Start of the mapped file
+	size_t Size;		// Size of the mapped file
+	void* File;			// OS file handle (Windows only)
+	void* Mapping;		// OS mapping handle (Windows only)
+	int Descriptor;		// File descriptor, kept open for kernel side copies (Unix only)
+} mapfile_struct;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern int mapfile_open(char*, mapfile_struct*);
+extern void mapfile_close(mapfile_struct*);
+extern void* mapfile_address(mapfile_struct*, size_t, size_t);
+extern void mapfile_prefetch(mapfile_struct*, size_t, size_t);
+extern int mapfile_copy(mapfile_struct*, size_t, size_t, FILE*);
+
+#endif //_MAPFILE_H
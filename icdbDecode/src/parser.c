@@ -23,6 +23,7 @@
 #include <stdint.h>						// Required for int32_t, uint32_t, ...
 #include <stdlib.h>						// Required for calloc to work properly
 #include "stringutil.h"					// Required for assemblePath
+#include "common.h"						// Required for keyArena
 #include "uid.h"						// Required for uid_union
 #include "./kicad/kicad_schematic.h"	// Required for StoreAsKicadFile
 #include "./cdbcatlg/page.h"			// Required for page
@@ -37,6 +38,14 @@
 */
 #define Exportpath "Export" // Path for exported files
 
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+char* exportPath = Exportpath; // Destination of the KiCad files
+uint32_t exportPathLength = sizeof(Exportpath);
+
 /*
 ******************************************************************
 * Function Prototypes
@@ -73,6 +82,7 @@ int ParseIcdb(char* path, uint32_t pathlength)
 	PathLen = assemblePath(&Path, path, pathlength, "s1", sizeof("s1"), DIR_SEPARATOR);
 	error = parseSessionFolder(Path, PathLen);
 	free(Path);
+	arena_free(&keyArena); // Parsing done, release memory for parsed keys
 
 	return error;
 }
@@ -122,9 +132,10 @@ int parseSessionFolder(char* path, uint32_t pathlength)
 	
 		// Parse cdbblks
 		error += parseCdbblks(SubPath, SubPathLen);
-		error += StoreAsKicadSchematic(Exportpath, sizeof(Exportpath), page);
+		error += StoreAsKicadSchematic(exportPath, exportPathLength, page);
 		free(SubPath);
 		initCdbblks();
+		arena_reset(&keyArena); // Release all keys of this page at once
 	}
 	initCdbcatlg();
 	free(Path);
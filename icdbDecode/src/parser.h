@@ -23,6 +23,14 @@
 */
 #include <stdint.h>		// Required for int32_t, uint32_t, ...
 
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+extern char* exportPath;
+extern uint32_t exportPathLength;
+
 /*
 ******************************************************************
 * Global Functions
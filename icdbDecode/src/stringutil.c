@@ -71,17 +71,33 @@ uint32_t createPath(char** destination, char* leftstring, uint32_t leftstringlen
 		if ((*destination)[i] == DIR_SEPARATOR_WINDOWS || (*destination)[i] == DIR_SEPARATOR_UNIX)
 		{
 			(*destination)[i] = '\0'; // Zero termintate string for mkdir command
-			#ifdef WIN32 // Building for Windows
-				mkdir(*destination);
-			#else // Building for Unix
-				mkdir(*destination, 0777);
-			#endif
+			makeDirectory(*destination);
 			(*destination)[i] = DIR_SEPARATOR; // Replace Slash / Backslash
 		}
 	}	
 	return completePathLength;
 }
 
+/*
+******************************************************************
+* - function name: makeDirectory()
+*
+* - description:  Creates a single folder. Existing folders are not touched
+*
+* - parameter:  zero terminated path
+*
+* - return value: -
+******************************************************************
+*/
+void makeDirectory(char* path)
+{
+	#ifdef WIN32 // Building for Windows
+		mkdir(path);
+	#else // Building for Unix
+		mkdir(path, 0777);
+	#endif
+}
+
 /*
 ******************************************************************
 * - function name: removeFilenameExtension()
@@ -334,6 +350,65 @@ char* stringAllSmall(char* name, unsigned int nameLen)
 	return output;
 }
 
+/*
+******************************************************************
+* - function name: matchPattern()
+*
+* - description:  checks a string against a glob pattern. '*' matches any number of characters, '?' a single character.
+*                 A pattern without wildcards is treated as prefix that ends at a folder boundary,
+*                 so "s1/cdbblks" selects that entry and everything below that folder, but not "s1/cdbblksX"
+*
+* - parameter:  zero terminated pattern; zero terminated string
+*
+* - return value: 1 if the string matches, 0 otherwise
+******************************************************************
+*/
+int matchPattern(char* pattern, char* string)
+{
+	char* starPattern = NULL;
+	char* starString = NULL;
+	if (strpbrk(pattern, "*?") == NULL)
+	{
+		// The prefix has to end at a folder boundary, "s1/cdbblks" must not select "s1/cdbblksX"
+		size_t Length = strlen(pattern);
+		if (strncmp(pattern, string, Length) != 0)
+		{
+			return 0;
+		}
+		return Length == 0 || string[Length] == '\0' || string[Length] == DIR_SEPARATOR_UNIX || string[Length] == DIR_SEPARATOR_WINDOWS ||
+			pattern[Length - 1] == DIR_SEPARATOR_UNIX || pattern[Length - 1] == DIR_SEPARATOR_WINDOWS;
+	}
+	while (*string != '\0')
+	{
+		if (*pattern == '*')
+		{
+			// Remember position, first try to match nothing
+			starPattern = ++pattern;
+			starString = string;
+		}
+		else if (*pattern == '?' || *pattern == *string)
+		{
+			pattern++;
+			string++;
+		}
+		else if (starPattern != NULL)
+		{
+			// Let the last star consume one more character
+			pattern = starPattern;
+			string = ++starString;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	while (*pattern == '*')
+	{
+		pattern++;
+	}
+	return *pattern == '\0';
+}
+
 /*
 ******************************************************************
 * - function name: stringLen()
@@ -39,10 +39,12 @@ extern uint32_t assemblePath(char**, char*, uint32_t, char*, uint32_t, char);
 extern void removeFilenameExtension(char* , uint32_t*);
 extern unsigned int removeFilePath(char*, unsigned int, char**);
 extern uint32_t createPath(char**, char*, uint32_t, char*, uint32_t, char);
+extern void makeDirectory(char*);
 extern char* stringSmall(char*, unsigned int);
 extern char* stringBig(char*, unsigned int);
 extern char* stringAllBig(char*, unsigned int);
 extern char* stringAllSmall(char*, unsigned int);
 unsigned int stringLen(char*, unsigned int);
+extern int matchPattern(char*, char*);
 
 #endif //_STRINGUTIL_H
\ No newline at end of file
@@ -0,0 +1,288 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "tar.h"
+#include <stdio.h>		// Required for fopen, fwrite
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcpy
+#include "log.h"		// Required for LogDetachStdout
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define TAR_BLOCK_SIZE 512			// Everything in a tar archive is aligned to blocks of this size
+#define TAR_NAME_SIZE 100			// Size of the name field
+#define TAR_PREFIX_SIZE 155			// Size of the ustar prefix field
+#define TAR_TYPE_FILE '0'			// Regular file
+#define TAR_TYPE_HARDLINK '1'		// Hard link to a previous entry
+#define TAR_TYPE_LONGNAME 'L'		// GNU extension, the data holds the name of the next entry
+#define _CRT_SECURE_NO_DEPRECATE	// Disable insecure function warning in VisualStudio
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct tar_header_struct
+{
+	char name[TAR_NAME_SIZE];
+	char mode[8];
+	char uid[8];
+	char gid[8];
+	char size[12];
+	char mtime[12];
+	char chksum[8];
+	char typeflag;
+	char linkname[TAR_NAME_SIZE];
+	char magic[6];
+	char version[2];
+	char uname[32];
+	char gname[32];
+	char devmajor[8];
+	char devminor[8];
+	char prefix[TAR_PREFIX_SIZE];
+	char padding[12];
+}tar_header_struct;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+int tar_header(FILE*, char*, unsigned int, char, char*, unsigned int, size_t, time_t);
+int tar_data(FILE*, const void*, size_t);
+void tar_octal(char*, size_t, uint64_t);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	tar_open()
+*
+* - description: 	Creates a tar archive. For "-" the archive is written to stdout,
+*					all other terminal output of the program is moved to stderr then
+*
+* - parameter: 		path of archive or "-"
+*
+* - return value: 	filepointer or NULL on error
+******************************************************************
+*/
+FILE* tar_open(char* path)
+{
+	if (strcmp(path, "-") != 0)
+	{
+		return fopen(path, "wb");
+	}
+	return LogDetachStdout(); // Messages go to stderr, the archive keeps the real stdout
+}
+
+/*
+******************************************************************
+* - function name:	tar_add()
+*
+* - description: 	Appends a regular file to a tar archive
+*
+* - parameter: 		filepointer; name inside the archive; length of name; file content; size of file content; modification time
+*
+* - return value: 	error code
+******************************************************************
+*/
+int tar_add(FILE* archive, char* name, unsigned int nameLength, const uint8_t* data, size_t size, time_t mtime)
+{
+	if (tar_header(archive, name, nameLength, TAR_TYPE_FILE, NULL, 0, size, mtime) != 0)
+	{
+		return -1;
+	}
+	return tar_data(archive, data, size);
+}
+
+/*
+******************************************************************
+* - function name:	tar_link()
+*
+* - description: 	Appends a hard link to a file already stored in the archive
+*
+* - parameter: 		filepointer; name inside the archive; length of name; name of the existing entry; length of existing name; modification time
+*
+* - return value: 	error code
+******************************************************************
+*/
+int tar_link(FILE* archive, char* name, unsigned int nameLength, char* target, unsigned int targetLength, time_t mtime)
+{
+	return tar_header(archive, name, nameLength, TAR_TYPE_HARDLINK, target, targetLength, 0, mtime);
+}
+
+/*
+******************************************************************
+* - function name:	tar_close()
+*
+* - description: 	Writes the end of archive marker and closes the archive
+*
+* - parameter: 		filepointer
+*
+* - return value: 	error code
+******************************************************************
+*/
+int tar_close(FILE* archive)
+{
+	uint8_t Zero[TAR_BLOCK_SIZE * 2] = { 0 };
+	int error = fwrite(Zero, sizeof(uint8_t), sizeof(Zero), archive) != sizeof(Zero);
+	if (fclose(archive) != 0)
+	{
+		error = -1;
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	tar_header()
+*
+* - description: 	Writes an ustar header. Names that do not fit into name and prefix are stored in a GNU long name entry first
+*
+* - parameter: 		filepointer; name; length of name; type; link target or NULL; length of link target; size of data; modification time
+*
+* - return value: 	error code
+******************************************************************
+*/
+int tar_header(FILE* archive, char* name, unsigned int nameLength, char type, char* target, unsigned int targetLength, size_t size, time_t mtime)
+{
+	tar_header_struct Header;
+	unsigned int checksum = 0;
+	unsigned int split = 0;
+
+	memset(&Header, 0, sizeof(Header));
+	if (targetLength > TAR_NAME_SIZE)
+	{
+		return -1; // Entries are at most 160 characters, so this does not happen for database files
+	}
+
+	// Split long names into prefix and name at a separator
+	if (nameLength > TAR_NAME_SIZE)
+	{
+		for (split = nameLength - 1; split > 0; split--)
+		{
+			if (name[split] == '/' && split <= TAR_PREFIX_SIZE && nameLength - split - 1 <= TAR_NAME_SIZE)
+			{
+				break;
+			}
+		}
+		if (split == 0)
+		{
+			// No usable separator
+			if (tar_header(archive, "././@LongLink", sizeof("././@LongLink") - 1, TAR_TYPE_LONGNAME, NULL, 0, nameLength + 1, mtime) != 0 ||
+				tar_data(archive, name, nameLength + 1) != 0)
+			{
+				return -1;
+			}
+			nameLength = TAR_NAME_SIZE;
+		}
+		else
+		{
+			memcpy(Header.prefix, name, split);
+			name += split + 1;
+			nameLength -= split + 1;
+		}
+	}
+	memcpy(Header.name, name, nameLength);
+	if (target != NULL)
+	{
+		memcpy(Header.linkname, target, targetLength);
+	}
+	tar_octal(Header.mode, sizeof(Header.mode), 0644);
+	tar_octal(Header.uid, sizeof(Header.uid), 0);
+	tar_octal(Header.gid, sizeof(Header.gid), 0);
+	tar_octal(Header.size, sizeof(Header.size), size);
+	tar_octal(Header.mtime, sizeof(Header.mtime), mtime > 0 ? (uint64_t)mtime : 0);
+	Header.typeflag = type;
+	memcpy(Header.magic, "ustar", 6);
+	memcpy(Header.version, "00", 2);
+
+	// Checksum is calculated with the checksum field set to blanks
+	memset(Header.chksum, ' ', sizeof(Header.chksum));
+	for (size_t i = 0; i < sizeof(Header); i++)
+	{
+		checksum += ((uint8_t*)&Header)[i];
+	}
+	tar_octal(Header.chksum, sizeof(Header.chksum) - 1, checksum);
+	return fwrite(&Header, sizeof(Header), 1, archive) != 1;
+}
+
+/*
+******************************************************************
+* - function name:	tar_data()
+*
+* - description: 	Writes file content and pads it to a full block
+*
+* - parameter: 		filepointer; data; size of data
+*
+* - return value: 	error code
+******************************************************************
+*/
+int tar_data(FILE* archive, const void* data, size_t size)
+{
+	uint8_t Zero[TAR_BLOCK_SIZE] = { 0 };
+	size_t padding = (TAR_BLOCK_SIZE - (size % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE;
+	if (size > 0 && fwrite(data, sizeof(uint8_t), size, archive) != size)
+	{
+		return -1;
+	}
+	if (padding > 0 && fwrite(Zero, sizeof(uint8_t), padding, archive) != padding)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	tar_octal()
+*
+* - description: 	Stores a number as zero terminated octal text, padded with leading zeros
+*
+* - parameter: 		destination field; size of field; value
+*
+* - return value: 	-
+******************************************************************
+*/
+void tar_octal(char* field, size_t size, uint64_t value)
+{
+	field[size - 1] = '\0';
+	for (size_t i = size - 1; i > 0; i--)
+	{
+		field[i - 1] = (char)('0' + (value & 7));
+		value >>= 3;
+	}
+}
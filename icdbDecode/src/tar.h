@@ -0,0 +1,40 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+#ifndef _TAR_H
+#define _TAR_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for file type
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+#include <time.h>		// Required for time_t
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern FILE* tar_open(char*);
+extern int tar_add(FILE*, char*, unsigned int, const uint8_t*, size_t, time_t);
+extern int tar_link(FILE*, char*, unsigned int, char*, unsigned int, time_t);
+extern int tar_close(FILE*);
+
+#endif //_TAR_H
@@ -23,21 +23,45 @@
 #include <stdio.h>		// Required for fprint, fopen, ...
 #include <stdlib.h>		// Required for calloc to work properly
 #include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcpy
 #include <time.h>		// Required for time_t
 #include <zlib.h>		// Required for decompression
 #include "common.h"		// Required for myfopen
 #include "stringutil.h" // Required for createPath
-#include "list.h"		// Required for list
+#include "mapfile.h"	// Required for mapfile_open
+#include "workerpool.h"	// Required for workerpool_run
+#include "log.h"		// Required for LogCaptureStart
+#include "hash.h"		// Required for hash_init
+#include "vfs.h"		// Required for vfs_add
+#include "manifest.h"	// Required for manifest_load
+#include "tar.h"		// Required for tar_add
+#include "inflater.h"	// Required for inflater_oneshot
+#include "writer.h"		// Required for writer_open
 
 #ifdef WIN32 // Building for Windows
 	#include <windows.h> // Required for Linking of files
+#else // Building for Unix
+	#include <fcntl.h>		// Required for open
+	#include <unistd.h>		// Required for link, unlink
+	#include <sys/ioctl.h>	// Required for ioctl
+	#ifdef __linux__
+		#include <linux/fs.h>	// Required for FICLONE
+	#endif
 #endif
 /*
 ******************************************************************
 * Global Defines
 ******************************************************************
 */
-#define DECOMPRESS_CHUNK_SIZE 1024
+#define DECOMPRESS_CHUNK_SIZE 0x10000		// Output buffer for streaming decompression (64 KiB)
+#define COMPRESSION_HEADER_SIZE 5			// Header in front of compressed payloads
+#define PREFETCH_GAP 0x10000				// Fragments closer than this are prefetched as one range (64 KiB)
+#define WRITE_BUFFER_SIZE 0x10000			// Output buffer of each extracted file, one write per inflated chunk (64 KiB)
+#define GUID_TEXT_SIZE 60					// Decoded GUID: 12 groups of 4 hex digits, separated by '-'
+#define PARSER_CATALOG_PATTERN "s1/cdbcatlg/*.v"	// Catalog files read by the parser
+#define PARSER_BLOCK_PATTERN "s1/cdbblks/*/*.v"	// Block files read by the parser
+#define DEDUPE_PROBE_NAME "\\icdbDecode.probe"		// Test file for the link support of the destination
+#define DEDUPE_PROBE_LINK_NAME "\\icdbDecode.probelink"
 #define _CRT_SECURE_NO_DEPRECATE			// Disable insecure function warning in VisualStudio
 
 /*
@@ -113,12 +137,87 @@ typedef struct file_struct
 
 typedef struct fragment_struct
 {
-	int payload_length; // Length of payload in this fragment
-	int fragment_length; // Total length of this fragment (Header + Payload + Padding)
-	int duplicates; // Number of files containing the same fragment of data
-	int next_fragment; // Start address of the next fragment, 0 if there is no next fragment
+	uint32_t payload_length; // Length of payload in this fragment
+	uint32_t fragment_length; // Total length of this fragment (Header + Payload + Padding)
+	uint32_t duplicates; // Number of files containing the same fragment of data
+	uint32_t next_fragment; // Start address of the next fragment, 0 if there is no next fragment
 }fragment_struct;
 
+typedef struct inflate_state_struct
+{
+	z_stream ZStream; // Decompression state, reset for every payload
+	unsigned char* Buffer; // Output buffer for decompression
+	int Initialized; // inflateInit was called on ZStream
+}inflate_state_struct;
+
+typedef struct export_stream_struct
+{
+	FILE* destFile; // Destination file, NULL if the file is not written to disk
+	mapfile_struct* Source; // Mapping the data comes from, allows kernel side copies of plain data. NULL to always write through user space
+	void* Writer; // io_uring writer of the worker the file is written with, NULL if written through destFile
+	int KeepInMemory; // Collect the output in Memory
+	uint8_t* Memory; // Output kept in memory
+	size_t MemoryLength; // Number of bytes in Memory
+	size_t MemorySize; // Allocated size of Memory
+	uint32_t DataSize; // Total payload size
+	int Compressed; // -1 until the header is read, 0 for plain data, 1 for compressed data
+	int Finished; // End of compressed stream reached
+	int Error; // Decompression failed, drop the remaining data
+	int Quiet; // Do not log progress, only errors
+	uint8_t Header[COMPRESSION_HEADER_SIZE]; // Start of payload, used to detect compression
+	unsigned int HeaderLength; // Number of bytes in Header
+	size_t DecompressedSize; // Number of bytes inflated so far
+	size_t OutputSize; // Number of bytes output so far
+	uint32_t Checksum; // CRC-32 of the output, only calculated in verify mode
+	inflate_state_struct* State; // Decompression state, kept across fragments. Reused by all files of a worker, or Local
+	inflate_state_struct Local; // Decompression state of a stream without a worker state
+}export_stream_struct;
+
+typedef struct read_extent_struct
+{
+	uint32_t Address; // Start of fragment
+	size_t Length; // Length of fragment header and payload
+}read_extent_struct;
+
+typedef struct export_result_struct
+{
+	int Error; // Error code of this file
+	uint8_t* Data; // File content, if kept in memory
+	size_t DataSize; // Size of file content
+	char* Log; // Captured log output
+	size_t LogLength; // Length of captured log output
+	int Skipped; // File is unchanged since the last extraction and was not written
+	uint32_t Checksum; // CRC-32 of the file content, only calculated in verify mode
+	size_t OutputSize; // Size of the file content, also if not kept in memory
+	int Written; // The job of this file ran and its destination file may exist
+}export_result_struct;
+
+typedef struct export_struct
+{
+	mapfile_struct* sourceFile; // Mapped database
+	file_struct** file; // Directory
+	file_struct** Original; // First file sharing the payload of each file, NULL for unique payloads
+	unsigned int* OriginalIndex; // Index of the first file sharing the payload of each file
+	void* Manifest; // Manifest of the previous extraction, NULL if every file is written
+	unsigned int numThreads; // Number of worker threads
+	unsigned int DuplicateCnt; // Count duplicate files
+	unsigned int CorruptCnt; // Count files failing verification
+	inflate_state_struct* Inflater; // Decompression state of each worker thread
+	unsigned int InflaterCnt; // Number of decompression states
+	void** Writer; // io_uring writer of each worker thread, NULL if the files are written through stdio
+	time_t EditTime; // Modification time of archive entries
+	export_result_struct* Result; // Result of each file
+}export_struct;
+
+typedef struct icdb_struct
+{
+	mapfile_struct sourceFile; // Mapped database
+	databaseHeader_Struct Header; // Database header
+	file_struct** file; // Directory
+	unsigned int numFiles; // Number of loaded files
+	void* Index; // Normalized file name -> file_struct
+}icdb_struct;
+
 /*
 ******************************************************************
 * Global Variables
@@ -127,6 +226,18 @@ typedef struct fragment_struct
 int nontDecompress = 0;
 int linkLongLongFiles = 0;
 int noLongLongFiles = 0;
+int dedupeFiles = 0; // Write duplicates as reflink or hardlink of the first copy
+int dedupeCopies = 0; // The destination supports no links, duplicates are written like unique files
+int memoryFiles = 0; // Keep extracted files in memory for the parser
+int noWriteFiles = 0; // Do not write extracted files to disk
+unsigned int numThreads = 1;
+char** includePattern = NULL; // Only extract entries matching one of these patterns
+unsigned int includePatternCnt = 0;
+unsigned int numExtractedFiles = 0; // Number of entries extracted by the last UnpackIcdb call
+int updateFiles = 0; // Only write files changed since the last extraction
+FILE* tarFile = NULL; // Write extracted files into this tar archive instead of single files
+int verifyFiles = 0; // Only check the integrity of all files and print their checksums
+FILE* verifyFile = NULL; // Destination of the checksum list, the log is moved to stderr meanwhile
 
 int storepathLength = 0;
 char* storepath = NULL;
@@ -140,14 +251,48 @@ char* databasepath = NULL;
 * Function Prototypes
 ******************************************************************
 */
-int decodeDatabaseHeader(FILE*, databaseHeader_Struct*);
-int decodefileList(FILE*, databaseHeader_Struct*, file_list_struct*);
-int decodefile(FILE*, file_struct*);
-int exportFiles(FILE*, databaseHeader_Struct*, file_struct**);
+int decodeDatabaseHeader(mapfile_struct*, databaseHeader_Struct*);
+void printDatabaseHeader(mapfile_struct*, databaseHeader_Struct*);
+void freeDatabaseHeader(databaseHeader_Struct*);
+int loadDirectory(mapfile_struct*, databaseHeader_Struct*, file_struct***, unsigned int*);
+unsigned int normalizeName(const char*, unsigned int, char*);
+unsigned int selectFiles(file_struct**, unsigned int);
+int decodefileList(mapfile_struct*, uint32_t, databaseHeader_Struct*, file_list_struct**);
+int decodefile(mapfile_struct*, uint32_t, file_struct**);
+int exportFiles(mapfile_struct*, databaseHeader_Struct*, file_struct**, unsigned int);
+void exportJob(void*, unsigned int);
+int exportDone(void*, unsigned int);
+int exportFile(mapfile_struct*, file_struct*, unsigned int, file_struct*, void*, inflate_state_struct*, void*, export_result_struct*);
+int unchangedFile(void*, file_struct*);
+void writeManifest(export_struct*, databaseHeader_Struct*, unsigned int);
+void prefetchFiles(export_struct*, unsigned int);
+void createDirectories(file_struct**, unsigned int);
+int compareExtent(const void*, const void*);
+int mapRead(mapfile_struct*, uint32_t*, void*, uint32_t);
+int mapReadString(mapfile_struct*, uint32_t*, uint32_t*, char**);
 char* makePath(char*, int, char*, int);
+FILE* openFile(file_struct*, char*);
+int openWriter(file_struct*, void*);
+void createWriters(export_struct*);
+int finishWriters(export_struct*);
+void removeFile(file_struct*);
 int mylink(char*, int, char*, int, char*, int);
+int mydedupe(char*, int, char*, int, char*, int);
+int probeDedupe(void);
+int readsPayload(file_struct*);
+int keepsInMemory(file_struct*);
 void printGUID(uint8_t Guid[24]);
-int decompress(char*, int, char**);
+void formatGUID(uint8_t Guid[24], char*);
+unsigned int countFragments(mapfile_struct*, file_struct*);
+void printJSON(FILE*, const char*);
+void streamInit(export_stream_struct*, FILE*, int, uint32_t);
+void streamWrite(export_stream_struct*, const uint8_t*, uint32_t);
+void streamOutput(export_stream_struct*, const void*, size_t);
+void streamOneShot(export_stream_struct*, const uint8_t*, uint32_t);
+void streamFinish(export_stream_struct*, uint8_t**, size_t*);
+void streamClose(export_stream_struct*);
+int stateReady(inflate_state_struct*);
+void stateFree(inflate_state_struct*);
 
 /*
 ******************************************************************
@@ -169,85 +314,57 @@ int decompress(char*, int, char**);
 int UnpackIcdb(char* sourcepath, int sourcepathLength, char* destinationpath, int destinationpathLength)
 {
 	int error = 0;
-	FILE* sourceFile = NULL;
+	mapfile_struct sourceFile;
 	databaseHeader_Struct* databaseHeader = NULL;
-	file_list_struct** fileList = NULL;
 	file_struct** file = NULL;
 	unsigned int fileCNT = 0;
 	
 	storepathLength = destinationpathLength;
 	storepath = destinationpath;
+	numExtractedFiles = 0;
 
 	databasepathLength = sourcepathLength;
 	databasepath = sourcepath;
 	
-	// Open source file
-	sourceFile = fopen(sourcepath, "rb");
-	if (sourceFile != 0)
+	// Map source file into memory
+	error = mapfile_open(sourcepath, &sourceFile);
+	if (error == 0)
 	{
 		// Read database header
-		databaseHeader = (databaseHeader_Struct*)malloc(sizeof(databaseHeader_Struct));
-		error |= decodeDatabaseHeader(sourceFile, databaseHeader);
-
-		// Allocate memory for file array
-		fileList = (file_list_struct**)malloc(sizeof(file_list_struct) * databaseHeader->num_lists);
-		file = (file_struct**)malloc(sizeof(file_struct) * databaseHeader->num_files);
-		
-		// Go to first file list
-		fseek(sourceFile, databaseHeader->first_list, SEEK_SET);
-
-		// Read in all files
-		for (unsigned int i = 0; i < databaseHeader->num_lists; i++)
+		databaseHeader = (databaseHeader_Struct*)calloc(1, sizeof(databaseHeader_Struct));
+		if (databaseHeader == NULL || sourceFile.Size < 0x68)
 		{
-			file_list_struct* temp_fileList = (file_list_struct*)malloc(sizeof(file_list_struct));
-
-			error |= decodefileList(sourceFile, (databaseHeader_Struct*)&databaseHeader, (file_list_struct*) temp_fileList);
-
-			*(fileList + i) = temp_fileList;
-			
-			// Read in all files from this list
-			for (int j = 0; j < temp_fileList->file_cnt; j++)
-			{
-				file_struct* temp_file = (file_struct*)malloc(sizeof(file_struct));
-
-				error |= decodefile(sourceFile, temp_file);
-
-				*(file + fileCNT) = temp_file;
-
-				fileCNT++;
-
-				if (fileCNT > databaseHeader->num_files)
-				{
-					myPrint("file entry count mismatch! %d and %d\n", fileCNT, databaseHeader->num_files);
-					error |= 1;
-					break;
-				}
-			}
-
-			if (temp_fileList->next_file_list != 0)
-			{
-				// Go to next file list
-				fseek(sourceFile, temp_fileList->next_file_list, SEEK_SET);
-			}
-			else
-			{
-				if (i + 1 != databaseHeader->num_lists)
-				{
-					myPrint("file size mismatch! %d and %d\n", i + 1, databaseHeader->num_lists);
-					error |= 1;
-				}
-				break;
-			}
+			myPrint("Failed to read database header of [%s]!\n", sourcepath);
+			mapfile_close(&sourceFile);
+			free(databaseHeader);
+			return -1;
+		}
+		error |= decodeDatabaseHeader(&sourceFile, databaseHeader);
+		if (error == 0)
+		{
+			printDatabaseHeader(&sourceFile, databaseHeader);
 		}
-		if (fileCNT != databaseHeader->num_files)
+
+		// Read in all files
+		if (loadDirectory(&sourceFile, databaseHeader, &file, &fileCNT) < 0)
 		{
-			myPrint("file count mismatch! %d and %d\n", fileCNT, databaseHeader->num_files);
-			error |= 1;
+			mapfile_close(&sourceFile);
+			freeDatabaseHeader(databaseHeader);
+			free(databaseHeader);
+			return -1;
 		}
+		error |= (fileCNT != databaseHeader->num_files);
 
 		myPrint("%d block(s) with %d total entries loaded.\n\n", databaseHeader->num_lists, databaseHeader->num_files);
 
-		if (exportFiles(sourceFile, databaseHeader, file) == 0 && error == 0)
+		int exportError = exportFiles(&sourceFile, databaseHeader, file, fileCNT);
+		if (verifyFiles == 1)
+		{
+			// Damaged entries are the result of a verification
+			myPrint(exportError == 0 && error == 0 ? "Verification successful!\n" : "Verification failed!\n");
+			error |= exportError;
+		}
+		else if (exportError == 0 && error == 0)
 		{
 			myPrint("Successfully written %d files!\n", databaseHeader->num_files);
 		}
@@ -256,14 +373,19 @@ int UnpackIcdb(char* sourcepath, int sourcepathLength, char* destinationpath, in
 			myPrint("Write operation was not successful! \n");
 		}
 
-		fclose(sourceFile);
+		mapfile_close(&sourceFile);
 
+		freeDatabaseHeader(databaseHeader);
 		free(databaseHeader);
-		free(fileList);
 		free(file);
 
 		return error;
 	}
+	else if (error == MAPFILE_TOO_LARGE)
+	{
+		myPrint("Failed to map [%s], the database does not fit into the address space of this build. Use a 64 bit build!\n", sourcepath);
+		return -1;
+	}
 	else
 	{
 		myPrint("Failed to open [%s]!\n", sourcepath);
@@ -271,525 +393,1939 @@ int UnpackIcdb(char* sourcepath, int sourcepathLength, char* destinationpath, in
 	}
 }
 
-
 /*
 ******************************************************************
-* Local Functions
+* - function name:	icdb_open()
+*
+* - description: 	Opens a database for random access. The directory is read once and indexed by file name,
+*					payloads are only read and decompressed when an entry is requested with icdb_read()
+*
+* - parameter: 		filepath string
+*
+* - return value: 	database handle or NULL on error
 ******************************************************************
 */
+void* icdb_open(char* sourcepath)
+{
+	char Name[sizeof(((file_struct*)0)->filename)];
+	icdb_struct* icdb = calloc(1, sizeof(icdb_struct));
+	if (icdb == NULL)
+	{
+		return NULL;
+	}
+	if (mapfile_open(sourcepath, &icdb->sourceFile) != 0)
+	{
+		free(icdb);
+		return NULL;
+	}
+	if (icdb->sourceFile.Size < 0x68 || decodeDatabaseHeader(&icdb->sourceFile, &icdb->Header) != 0 ||
+		loadDirectory(&icdb->sourceFile, &icdb->Header, &icdb->file, &icdb->numFiles) < 0)
+	{
+		icdb_close((void**)&icdb);
+		return NULL;
+	}
+
+	// Index all entries by their normalized name
+	icdb->Index = hash_init(icdb->numFiles);
+	if (icdb->Index == NULL)
+	{
+		icdb_close((void**)&icdb);
+		return NULL;
+	}
+	for (unsigned int i = 0; i < icdb->numFiles; i++)
+	{
+		unsigned int NameLength = normalizeName(icdb->file[i]->filename, icdb->file[i]->filename_length, Name);
+		if (hash_insert(icdb->Index, Name, NameLength, icdb->file[i]) < 0)
+		{
+			icdb_close((void**)&icdb);
+			return NULL;
+		}
+	}
+	return icdb;
+}
 
 /*
 ******************************************************************
-* - function name:	decodeDatabaseHeader()
+* - function name:	icdb_lookup()
 *
-* - description: 	Read in, and print database header
+* - description: 	Finds an entry of a database opened with icdb_open().
+*					Slash and backslash are treated the same, a leading separator is optional
 *
-* - parameter: 		file pointer.
+* - parameter: 		database handle; file name (e.g. "s1/cdbcatlg/catlgatl.v")
 *
-* - return value: 	error code
+* - return value: 	entry handle or NULL if the entry does not exist
 ******************************************************************
 */
-int decodeDatabaseHeader(FILE* sourceFile, databaseHeader_Struct* databaseHeader)
+void* icdb_lookup(void* head, char* filename)
 {
-	// Determine total file size
-	fseek(sourceFile, 0, SEEK_END);
-	int filesize = ftell(sourceFile);
-	rewind(sourceFile);
-
-	// Read beginning of file header
-	(void)!fread(databaseHeader, 0x68, 1, sourceFile);
-
-	if (databaseHeader != 0)
+	char Name[sizeof(((file_struct*)0)->filename)];
+	icdb_struct* icdb = head;
+	size_t Length = strlen(filename);
+	if (icdb == NULL || Length >= sizeof(Name))
 	{
-		// Check file size
-		if (filesize != databaseHeader->filesize && databaseHeader->file_version == 1009) // Pre 1009 doesn't contain filesize in the header
-		{
-			myPrint("Filesize mismatch! %d and %d\n", filesize, databaseHeader->filesize);
-			return -1;
-		}
-
-		// Go to second block of data in Header
-		fseek(sourceFile, 0x85C, SEEK_SET);
-
-		// Editor version
-		(void)!fread(&databaseHeader->iCDBdiagnostic_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->iCDBdiagnostic_length > 0)
-		{
-			databaseHeader->iCDBdiagnostic = malloc(databaseHeader->iCDBdiagnostic_length + 1);
-			if (databaseHeader->iCDBdiagnostic != 0)
-			{
-				(void)!fread(databaseHeader->iCDBdiagnostic, sizeof(char), databaseHeader->iCDBdiagnostic_length, sourceFile);
-				*((databaseHeader->iCDBdiagnostic) + databaseHeader->iCDBdiagnostic_length) = '\0';
-			}
-		}
-
-		// PC Name
-		(void)!fread(&databaseHeader->pc_name_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->pc_name_length > 0)
-		{
-			databaseHeader->pc_name = malloc(databaseHeader->pc_name_length + 1);
-			if (databaseHeader->pc_name != 0)
-			{
-				(void)!fread(databaseHeader->pc_name, sizeof(char), databaseHeader->pc_name_length, sourceFile);
-				*((databaseHeader->pc_name) + databaseHeader->pc_name_length) = '\0';
-			}
-		}
-
-		// Username
-		(void)!fread(&databaseHeader->user_name_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->user_name_length > 0)
-		{
-			databaseHeader->user_name = malloc(databaseHeader->user_name_length + 1);
-			if (databaseHeader->user_name != 0)
-			{
-				(void)!fread(databaseHeader->user_name, sizeof(char), databaseHeader->user_name_length, sourceFile);
-				*((databaseHeader->user_name) + databaseHeader->user_name_length) = '\0';
-			}
-		}
-
-		// Opening time
-		uint32_t tempTime;
-		(void)!fread(&tempTime, sizeof(uint32_t), 1, sourceFile);
-		databaseHeader->edittime = tempTime;
-
-		// User PID
-		(void)!fread(&databaseHeader->pid, sizeof(uint32_t), 1, sourceFile);
+		return NULL;
+	}
+	return hash_lookup(icdb->Index, Name, normalizeName(filename, (unsigned int)Length, Name));
+}
 
-		// Windows version info
-		(void)!fread(&databaseHeader->os_version_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->os_version_length > 0)
-		{
-			databaseHeader->os_version = malloc(databaseHeader->os_version_length + 1);
-			if (databaseHeader->os_version != 0)
-			{
-				(void)!fread(databaseHeader->os_version, sizeof(char), databaseHeader->os_version_length, sourceFile);
-				*((databaseHeader->os_version) + databaseHeader->os_version_length) = '\0';
-			}
-		}
+/*
+******************************************************************
+* - function name:	icdb_entry()
+*
+* - description: 	Returns an entry of a database opened with icdb_open() by its position in the directory
+*
+* - parameter: 		database handle; entry number, starting at 0
+*
+* - return value: 	entry handle or NULL if there are fewer entries
+******************************************************************
+*/
+void* icdb_entry(void* head, unsigned int i)
+{
+	icdb_struct* icdb = head;
+	if (icdb == NULL || i >= icdb->numFiles)
+	{
+		return NULL;
+	}
+	return icdb->file[i];
+}
 
-		// iCDBstring
-		(void)!fread(&databaseHeader->iCDB_string_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->iCDB_string_length > 0)
-		{
-			databaseHeader->iCDB_string = malloc(databaseHeader->iCDB_string_length + 1);
-			if (databaseHeader->iCDB_string != 0)
-			{
-				(void)!fread(databaseHeader->iCDB_string, sizeof(char), databaseHeader->iCDB_string_length, sourceFile);
-				*((databaseHeader->iCDB_string) + databaseHeader->iCDB_string_length) = '\0';
-			}
-		}
+/*
+******************************************************************
+* - function name:	icdb_read()
+*
+* - description: 	Reads the payload of an entry, decompressing it if required (unless nontDecompress is set)
+*
+* - parameter: 		database handle; entry handle; pointer to data pointer (must be freed by the caller, NULL for empty entries); pointer to data size
+*
+* - return value: 	error code
+******************************************************************
+*/
+int icdb_read(void* head, void* entry, uint8_t** data, size_t* size)
+{
+	icdb_struct* icdb = head;
+	file_struct* file = entry;
+	export_stream_struct Stream;
+	fragment_struct* fragment = NULL;
+	uint32_t next_fragment = 0;
+	uint64_t payload_lengthAcc = 0;
+	uint64_t FragmentCnt = 0;
+
+	*data = NULL;
+	*size = 0;
+	if (icdb == NULL || file == NULL)
+	{
+		return 1;
+	}
 
-		// Filepath
-		(void)!fread(&databaseHeader->filepath_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->filepath_length > 0)
+	streamInit(&Stream, NULL, 1, file->data_size);
+	Stream.Quiet = 1;
+	next_fragment = file->data_address;
+	do {
+		fragment = mapfile_address(&icdb->sourceFile, next_fragment, sizeof(fragment_struct));
+		if (fragment == NULL)
 		{
-			databaseHeader->filepath = malloc(databaseHeader->filepath_length + 1);
-			if (databaseHeader->filepath != 0)
-			{
-				(void)!fread(databaseHeader->filepath, sizeof(char), databaseHeader->filepath_length, sourceFile);
-				*((databaseHeader->filepath) + databaseHeader->filepath_length) = '\0';
-			}
+			streamClose(&Stream);
+			return 1;
 		}
-
-		// Settings path
-		(void)!fread(&databaseHeader->settingspath_length, sizeof(uint32_t), 1, sourceFile);
-		if (databaseHeader->settingspath_length > 0)
+		if ((fragment->payload_length > 0) && ((fragment->payload_length + payload_lengthAcc) <= file->data_size))
 		{
-			databaseHeader->settingspath = malloc(databaseHeader->settingspath_length + 1);
-			if (databaseHeader->settingspath != 0)
+			uint8_t* FragmentData = mapfile_address(&icdb->sourceFile, next_fragment + sizeof(fragment_struct), fragment->payload_length);
+			if (FragmentData == NULL)
 			{
-				(void)!fread(databaseHeader->settingspath, sizeof(char), databaseHeader->settingspath_length, sourceFile);
-				*((databaseHeader->settingspath) + databaseHeader->settingspath_length) = '\0';
+				streamClose(&Stream);
+				return 1;
 			}
+			streamWrite(&Stream, FragmentData, fragment->payload_length);
 		}
+		payload_lengthAcc += fragment->payload_length;
+		next_fragment = fragment->next_fragment;
+	} while (next_fragment != 0 && payload_lengthAcc < file->data_size && ++FragmentCnt <= file->data_size);
 
-		// Print version info
-		myPrint("********* Database Info *********\n");
-		myPrint("Database: \t\t[%s]\n", databasepath);
-		myPrint("File Format Version: \t[%d]", databaseHeader->file_version);
-		if (databaseHeader->file_version != 1009)
-		{
-			myPrint(" -> Unsupported Version. Results might be invalid! \n");
-		}
-		else
-		{
-			myPrint("\n");
-		}
-		myPrint("iCDB Server Version: \t[%d]\n", databaseHeader->iCDB_version);
-		myPrint("iCDB Database: \t\t[%s]\n", databaseHeader->iCDBdiagnostic);
-
-		char temp[20];
-		strftime(temp, 20, "%Y-%m-%d %H:%M:%S", localtime(&databaseHeader->edittime));
-		myPrint("Time: \t\t\t[%s]\n", temp);
-		myPrint("Location: \t\t[%s]\n", databaseHeader->filepath);
-		myPrint("Mashine: \t\t[%s]\n", databaseHeader->pc_name);
-		myPrint("User: \t\t\t[%s]\n", databaseHeader->user_name);
-		myPrint("PID: \t\t\t[%d]\n", databaseHeader->pid);
-		myPrint("Application: \t\t[%s]\n", databaseHeader->iCDB_string);
-		myPrint("Operating System: \t[%s]\n", databaseHeader->os_version);
-		myPrint("WDIR: \t\t\t[%s]\n", databaseHeader->settingspath);
-
-		myPrint("Database GUID: \t\t");
-		printGUID(databaseHeader->project_GUID);
-		myPrint("\n");
-
-		myPrint("Server GUID: \t\t");
-		printGUID(databaseHeader->server_GUID);
-		myPrint("\n");
-
-		myPrint("Total Filesize: \t[%d]\n", filesize);
-		myPrint("Unknown Value1: \t[%d]\n", databaseHeader->unknown1);
-		myPrint("Unknown Value2: \t[%d]\t\t\n", databaseHeader->unknown2);
-		myPrint("Unknown Value3: \t[%d] and [%d]\n", databaseHeader->unknown3[0], databaseHeader->unknown3[1]);
-		
-		
-		if (databaseHeader->always_zero != 0)
-		{
-			myPrint("always_zero in header is not zero, but %d!\n", databaseHeader->always_zero);
-		}
-		if (databaseHeader->always_zero2 != 0)
-		{
-			myPrint("always_zero2 in header is not zero, but %d!\n", databaseHeader->always_zero2);
-		}
-		myPrint("The file was saved %d times.\n", databaseHeader->opening_counter);
-		
-		myPrint("******* Database Info End *******\n");
-		myPrint("\n");
-		return 0;
+	if (payload_lengthAcc != file->data_size || Stream.Error != 0)
+	{
+		streamClose(&Stream);
+		return 1;
 	}
-	else
+	streamFinish(&Stream, data, size);
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	icdb_close()
+*
+* - description: 	Closes a database opened with icdb_open()
+*
+* - parameter: 		pointer to database handle
+*
+* - return value: 	-
+******************************************************************
+*/
+void icdb_close(void** head)
+{
+	icdb_struct* icdb = *head;
+	if (icdb != NULL)
 	{
-		return -1;
+		hash_cleanup(&icdb->Index);
+		free(icdb->file);
+		freeDatabaseHeader(&icdb->Header);
+		mapfile_close(&icdb->sourceFile);
+		free(icdb);
 	}
+	*head = NULL;
 }
 
 /*
 ******************************************************************
-* - function name:	decodefileList()
+* - function name:	ListIcdb()
 *
-* - description: 	Read in, and print data file list
+* - description: 	Prints the database header and the directory as TSV or JSON, without extracting anything.
+*					Only the file lists, file entries and fragment headers are read, payloads are never touched
 *
-* - parameter: 		file pointer; pointer to databaseHeader, pointer to fileList
+* - parameter: 		filepath string; LIST_TSV or LIST_JSON; text printed in front of the listing; output stream
 *
-* - return value: 	error code
+* - return value: 	error code, negative if nothing was listed, positive if the header or directory is damaged
 ******************************************************************
 */
-int decodefileList(FILE* sourceFile, databaseHeader_Struct* databaseHeader, file_list_struct* fileList)
+int ListIcdb(char* sourcepath, int format, char* prefix, FILE* output)
 {
-	// Read struct
-	(void)!fread(fileList, sizeof(file_list_struct), 1, sourceFile);
+	int error = 0;
+	mapfile_struct sourceFile;
+	databaseHeader_Struct databaseHeader = { 0 };
+	file_struct** file = NULL;
+	unsigned int fileCNT = 0;
+	unsigned int* Group = NULL;
+	char Name[sizeof(((file_struct*)0)->filename)];
+	char Guid[GUID_TEXT_SIZE];
+	char Time[20];
 
-	// Check if counter match
-	if (fileList->file_cnt != fileList->file_cnt2)
+	error = mapfile_open(sourcepath, &sourceFile);
+	if (error == MAPFILE_TOO_LARGE)
 	{
-		myPrint("File counter mismatch! %d and %d \n", fileList->file_cnt, fileList->file_cnt2);
-		return 1;
+		myPrint("Failed to map [%s], the database does not fit into the address space of this build. Use a 64 bit build!\n", sourcepath);
+		return -1;
 	}
-	// Check number of entries
-	if (fileList->file_cnt > 100)
+	if (error != 0)
 	{
-		myPrint("File counter to large! %d\n", fileList->file_cnt);
-		return 1;
+		myPrint("Failed to open [%s]!\n", sourcepath);
+		return -1;
 	}
-	// Check start code
-	if (fileList->magic != 0x6410)
+	if (sourceFile.Size < 0x68)
 	{
-		myPrint("Startcode mismatch! %d\n", fileList->magic);
-		return 1;
+		myPrint("Failed to read database header of [%s]!\n", sourcepath);
+		mapfile_close(&sourceFile);
+		return -1;
+	}
+	error |= decodeDatabaseHeader(&sourceFile, &databaseHeader);
+	if (loadDirectory(&sourceFile, &databaseHeader, &file, &fileCNT) < 0)
+	{
+		mapfile_close(&sourceFile);
+		freeDatabaseHeader(&databaseHeader);
+		return -1;
 	}
+	error |= (fileCNT != databaseHeader.num_files);
 
-	// Check "always zeros"
-	for (int i = 0; i < 4; i++)
+	// Files sharing a payload form a group, named after the first file (starting at 1)
+	Group = (unsigned int*)calloc(fileCNT + 1, sizeof(unsigned int));
+	void* Index = hash_init(fileCNT);
+	if (Group == NULL || Index == NULL)
 	{
-		if (fileList->always_zero[i] != 0)
+		myPrint("Out of memory!\n");
+		free(Group);
+		hash_cleanup(&Index);
+		free(file);
+		mapfile_close(&sourceFile);
+		freeDatabaseHeader(&databaseHeader);
+		return -1;
+	}
+	for (unsigned int i = 0; i < fileCNT; i++)
+	{
+		Group[i] = i + 1;
+		if (hash_insert(Index, &file[i]->data_address, sizeof(uint32_t), &file[i]) == 1)
 		{
-			myPrint("always_zero[%d] in file entry header is not zero, but %d!\n", i, fileList->always_zero);
+			file_struct** first = hash_lookup(Index, &file[i]->data_address, sizeof(uint32_t));
+			Group[i] = (unsigned int)(first - file) + 1;
 		}
 	}
-	if (fileList->always_zero2 != 0)
+	hash_cleanup(&Index);
+
+	fputs(prefix, output);
+	strftime(Time, sizeof(Time), "%Y-%m-%d %H:%M:%S", localtime(&databaseHeader.edittime));
+	if (format == LIST_JSON)
 	{
-		myPrint("always_zero2 in file entry header is not zero, but %d!\n", fileList->always_zero2);
+		fputs("{\n\t\"database\": ", output);
+		printJSON(output, sourcepath);
+		fprintf(output, ",\n\t\"header\": {\n\t\t\"file_version\": %u,\n\t\t\"icdb_version\": %u,\n", databaseHeader.file_version, databaseHeader.iCDB_version);
+		formatGUID(databaseHeader.project_GUID, Guid);
+		fprintf(output, "\t\t\"project_guid\": \"%s\",\n", Guid);
+		formatGUID(databaseHeader.server_GUID, Guid);
+		fprintf(output, "\t\t\"server_guid\": \"%s\",\n", Guid);
+		fprintf(output, "\t\t\"opening_counter\": %u,\n\t\t\"edit_time\": \"%s\",\n\t\t\"pid\": %u,\n", databaseHeader.opening_counter, Time, databaseHeader.pid);
+		fputs("\t\t\"diagnostic\": ", output);
+		printJSON(output, databaseHeader.iCDBdiagnostic);
+		fputs(",\n\t\t\"machine\": ", output);
+		printJSON(output, databaseHeader.pc_name);
+		fputs(",\n\t\t\"user\": ", output);
+		printJSON(output, databaseHeader.user_name);
+		fputs(",\n\t\t\"os_version\": ", output);
+		printJSON(output, databaseHeader.os_version);
+		fputs(",\n\t\t\"application\": ", output);
+		printJSON(output, databaseHeader.iCDB_string);
+		fputs(",\n\t\t\"location\": ", output);
+		printJSON(output, databaseHeader.filepath);
+		fputs(",\n\t\t\"wdir\": ", output);
+		printJSON(output, databaseHeader.settingspath);
+		fprintf(output, ",\n\t\t\"filesize\": %zu,\n\t\t\"entries\": %u\n\t},\n\t\"entries\": [", sourceFile.Size, fileCNT);
+		for (unsigned int i = 0; i < fileCNT; i++)
+		{
+			Name[normalizeName(file[i]->filename, file[i]->filename_length, Name)] = '\0';
+			formatGUID(file[i]->fileGUID, Guid);
+			fprintf(output, i == 0 ? "\n\t\t{\"name\": " : ",\n\t\t{\"name\": ");
+			printJSON(output, Name);
+			fprintf(output, ", \"size\": %u, \"address\": %u, \"fragments\": %u, \"guid\": \"%s\", \"group\": %u}",
+				file[i]->data_size, file[i]->data_address, countFragments(&sourceFile, file[i]), Guid, Group[i]);
+		}
+		fputs(fileCNT == 0 ? "]\n}\n" : "\n\t]\n}\n", output);
 	}
-	return 0;
+	else
+	{
+		// Header as comment lines, so the table can be read by any TSV reader
+		fprintf(output, "# database\t%s\n# file_version\t%u\n# icdb_version\t%u\n", sourcepath, databaseHeader.file_version, databaseHeader.iCDB_version);
+		formatGUID(databaseHeader.project_GUID, Guid);
+		fprintf(output, "# project_guid\t%s\n", Guid);
+		formatGUID(databaseHeader.server_GUID, Guid);
+		fprintf(output, "# server_guid\t%s\n", Guid);
+		fprintf(output, "# opening_counter\t%u\n# edit_time\t%s\n# pid\t%u\n", databaseHeader.opening_counter, Time, databaseHeader.pid);
+		fprintf(output, "# diagnostic\t%s\n", databaseHeader.iCDBdiagnostic != NULL ? databaseHeader.iCDBdiagnostic : "");
+		fprintf(output, "# machine\t%s\n", databaseHeader.pc_name != NULL ? databaseHeader.pc_name : "");
+		fprintf(output, "# user\t%s\n", databaseHeader.user_name != NULL ? databaseHeader.user_name : "");
+		fprintf(output, "# os_version\t%s\n", databaseHeader.os_version != NULL ? databaseHeader.os_version : "");
+		fprintf(output, "# application\t%s\n", databaseHeader.iCDB_string != NULL ? databaseHeader.iCDB_string : "");
+		fprintf(output, "# location\t%s\n", databaseHeader.filepath != NULL ? databaseHeader.filepath : "");
+		fprintf(output, "# wdir\t%s\n", databaseHeader.settingspath != NULL ? databaseHeader.settingspath : "");
+		fprintf(output, "# filesize\t%zu\n# entries\t%u\n", sourceFile.Size, fileCNT);
+		fputs("index\tname\tsize\taddress\tfragments\tguid\tgroup\n", output);
+		for (unsigned int i = 0; i < fileCNT; i++)
+		{
+			Name[normalizeName(file[i]->filename, file[i]->filename_length, Name)] = '\0';
+			formatGUID(file[i]->fileGUID, Guid);
+			fprintf(output, "%u\t%s\t%u\t%u\t%u\t%s\t%u\n", i + 1, Name, file[i]->data_size, file[i]->data_address,
+				countFragments(&sourceFile, file[i]), Guid, Group[i]);
+		}
+	}
+	fflush(output);
+
+	free(Group);
+	free(file);
+	mapfile_close(&sourceFile);
+	freeDatabaseHeader(&databaseHeader);
+	return error != 0;
 }
 
 /*
 ******************************************************************
-* - function name:	decodefile()
+* - function name:	addIncludePattern()
 *
-* - description: 	Read in file
+* - description: 	Adds a normalized copy of an include pattern, so every database of a batch uses it as is
 *
-* - parameter: 		file pointer; pointer to databaseHeader, pointer to file
+* - parameter: 		pattern string
 *
 * - return value: 	error code
 ******************************************************************
 */
-int decodefile(FILE* sourceFile, file_struct* file)
+int addIncludePattern(char* pattern)
 {
-	int Address = ftell(sourceFile);
-	// Read file entry
-	(void)!fread(file, sizeof(file_struct), 1, sourceFile);
-
-	// Check address
-	if (Address != file->file_address)
-	{
-		myPrint("Address mismatch! %d and %d\n", Address, file->file_address);
-		return 1;
-	}
-
-	// Check filename length
-	if ( file->filename_length < 160 && file->filename_length > 0)
-	{
-		file->filename[file->filename_length] = '\0'; // Terminate filename. just in case
-	}
-	else
+	unsigned int Length = (unsigned int)strlen(pattern);
+	char* Pattern = malloc(Length + 1);
+	char** newPattern = realloc(includePattern, (includePatternCnt + 1) * sizeof(char*));
+	if (Pattern == NULL || newPattern == NULL)
 	{
-		myPrint("Wrong filename length: [%d]\n", file->filename_length);
-		return 1;
+		free(Pattern);
+		if (newPattern != NULL)
+		{
+			includePattern = newPattern;
+		}
+		return -1;
 	}
 
+	// Patterns use the same form as the name index
+	Pattern[normalizeName(pattern, Length, Pattern)] = '\0';
+	includePattern = newPattern;
+	includePattern[includePatternCnt++] = Pattern;
 	return 0;
 }
 
 /*
 ******************************************************************
-* - function name:	exportFiles()
+* - function name:	freeIncludePatterns()
 *
-* - description: 	Read in file payload, unite fragmented files, export files
+* - description: 	Frees all include patterns
 *
-* - parameter: 		file pointer; pointer to databaseHeader, pointer to file pointer
+* - parameter: 		-
 *
-* - return value: 	error code
+* - return value: 	-
 ******************************************************************
 */
-int exportFiles(FILE* sourceFile, databaseHeader_Struct* databaseHeader, file_struct** file)
+void freeIncludePatterns(void)
 {
-	char* Payload = 0;
-	fragment_struct fragment;
-	unsigned int payload_lengthAcc = 0; // Accumulate length of multiple fragments
-	uint32_t DuplicateTo = 0; // Duplicate files
-	unsigned int DuplicateCnt = 0; // Count duplicate files
-	unsigned int FragmentCnt = 0; // Count data fragments
-	for (unsigned int i = 0; i < databaseHeader->num_files; i++)
+	for (unsigned int i = 0; i < includePatternCnt; i++)
 	{
-		myPrint("%d: reading % .*s \n", i + 1, file[i]->filename_length, file[i]->filename);
-		// Check if payload is allocated to multiple files
-		
-		for (unsigned int j = 0; j < i; j++)
-		{
-			if(file[i]->data_address == file[j]->data_address)
-			{
-				DuplicateTo = j;
-				DuplicateCnt++;
-				myPrint("    File is identical to: [%s]!\n", file[DuplicateTo]->filename);
-				break;
-			}
-		}
-		
-		myPrint("    GUID:\t\t");
-		printGUID(file[i]->fileGUID);
-		myPrint("\n");
-		
-		myPrint("    Readable data:\t[");
-		for(int j = 0; j < 0x10; j++)
-		{
-			if(file[i]->data[j] >= 32) // Printable characters
-			{
-				myPrint("%c", file[i]->data[j]);
-			}
-			else // Control characters
-			{
-				myPrint(" 0x%02x ", file[i]->data[j]);
-			}
-		}
-		myPrint("]\n");
+		free(includePattern[i]);
+	}
+	free(includePattern);
+	includePattern = NULL;
+	includePatternCnt = 0;
+}
+
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	decodeDatabaseHeader()
+*
+* - description: 	Read in database header
+*
+* - parameter: 		pointer to mapped source file; pointer to databaseHeader
+*
+* - return value: 	error code
+******************************************************************
+*/
+int decodeDatabaseHeader(mapfile_struct* sourceFile, databaseHeader_Struct* databaseHeader)
+{
+	// Determine total file size
+	size_t filesize = sourceFile->Size;
+	uint32_t Address = 0;
+
+	// Read beginning of file header
+	if (databaseHeader != 0 && mapRead(sourceFile, &Address, databaseHeader, 0x68) == 0)
+	{
+		// Check file size
+		if (filesize != databaseHeader->filesize && databaseHeader->file_version == 1009) // Pre 1009 doesn't contain filesize in the header
+		{
+			myPrint("Filesize mismatch! %zu and %u\n", filesize, databaseHeader->filesize);
+			return -1;
+		}
+
+		// Go to second block of data in Header
+		Address = 0x85C;
+
+		// Editor version
+		mapReadString(sourceFile, &Address, &databaseHeader->iCDBdiagnostic_length, &databaseHeader->iCDBdiagnostic);
+
+		// PC Name
+		mapReadString(sourceFile, &Address, &databaseHeader->pc_name_length, &databaseHeader->pc_name);
+
+		// Username
+		mapReadString(sourceFile, &Address, &databaseHeader->user_name_length, &databaseHeader->user_name);
+
+		// Opening time
+		uint32_t tempTime = 0;
+		mapRead(sourceFile, &Address, &tempTime, sizeof(uint32_t));
+		databaseHeader->edittime = tempTime;
+
+		// User PID
+		mapRead(sourceFile, &Address, &databaseHeader->pid, sizeof(uint32_t));
+
+		// Windows version info
+		mapReadString(sourceFile, &Address, &databaseHeader->os_version_length, &databaseHeader->os_version);
+
+		// iCDBstring
+		mapReadString(sourceFile, &Address, &databaseHeader->iCDB_string_length, &databaseHeader->iCDB_string);
+
+		// Filepath
+		mapReadString(sourceFile, &Address, &databaseHeader->filepath_length, &databaseHeader->filepath);
+
+		// Settings path
+		mapReadString(sourceFile, &Address, &databaseHeader->settingspath_length, &databaseHeader->settingspath);
+
+		return 0;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+/*
+******************************************************************
+* - function name:	printDatabaseHeader()
+*
+* - description: 	Print database header
+*
+* - parameter: 		pointer to mapped source file; pointer to databaseHeader
+*
+* - return value: 	-
+******************************************************************
+*/
+void printDatabaseHeader(mapfile_struct* sourceFile, databaseHeader_Struct* databaseHeader)
+{
+	size_t filesize = sourceFile->Size;
+
+	// Print version info
+	myPrint("********* Database Info *********\n");
+	myPrint("Database: \t\t[%s]\n", databasepath);
+	myPrint("File Format Version: \t[%d]", databaseHeader->file_version);
+	if (databaseHeader->file_version != 1009)
+	{
+		myPrint(" -> Unsupported Version. Results might be invalid! \n");
+	}
+	else
+	{
+		myPrint("\n");
+	}
+	myPrint("iCDB Server Version: \t[%d]\n", databaseHeader->iCDB_version);
+	myPrint("iCDB Database: \t\t[%s]\n", databaseHeader->iCDBdiagnostic);
+
+	char temp[20];
+	strftime(temp, 20, "%Y-%m-%d %H:%M:%S", localtime(&databaseHeader->edittime));
+	myPrint("Time: \t\t\t[%s]\n", temp);
+	myPrint("Location: \t\t[%s]\n", databaseHeader->filepath);
+	myPrint("Mashine: \t\t[%s]\n", databaseHeader->pc_name);
+	myPrint("User: \t\t\t[%s]\n", databaseHeader->user_name);
+	myPrint("PID: \t\t\t[%d]\n", databaseHeader->pid);
+	myPrint("Application: \t\t[%s]\n", databaseHeader->iCDB_string);
+	myPrint("Operating System: \t[%s]\n", databaseHeader->os_version);
+	myPrint("WDIR: \t\t\t[%s]\n", databaseHeader->settingspath);
+
+	myPrint("Database GUID: \t\t");
+	printGUID(databaseHeader->project_GUID);
+	myPrint("\n");
+
+	myPrint("Server GUID: \t\t");
+	printGUID(databaseHeader->server_GUID);
+	myPrint("\n");
+
+	myPrint("Total Filesize: \t[%zu]\n", filesize);
+	myPrint("Unknown Value1: \t[%d]\n", databaseHeader->unknown1);
+	myPrint("Unknown Value2: \t[%d]\t\t\n", databaseHeader->unknown2);
+	myPrint("Unknown Value3: \t[%d] and [%d]\n", databaseHeader->unknown3[0], databaseHeader->unknown3[1]);
+	
+	
+	if (databaseHeader->always_zero != 0)
+	{
+		myPrint("always_zero in header is not zero, but %d!\n", databaseHeader->always_zero);
+	}
+	if (databaseHeader->always_zero2 != 0)
+	{
+		myPrint("always_zero2 in header is not zero, but %d!\n", databaseHeader->always_zero2);
+	}
+	myPrint("The file was saved %d times.\n", databaseHeader->opening_counter);
+	
+	myPrint("******* Database Info End *******\n");
+	myPrint("\n");
+}
+
+/*
+******************************************************************
+* - function name:	freeDatabaseHeader()
+*
+* - description: 	Frees the strings read in by decodeDatabaseHeader()
+*
+* - parameter: 		pointer to databaseHeader
+*
+* - return value: 	-
+******************************************************************
+*/
+void freeDatabaseHeader(databaseHeader_Struct* databaseHeader)
+{
+	free(databaseHeader->iCDBdiagnostic);
+	free(databaseHeader->pc_name);
+	free(databaseHeader->user_name);
+	free(databaseHeader->os_version);
+	free(databaseHeader->iCDB_string);
+	free(databaseHeader->filepath);
+	free(databaseHeader->settingspath);
+}
+
+/*
+******************************************************************
+* - function name:	loadDirectory()
+*
+* - description: 	Read in all file lists and file entries. The entries are referenced in place inside the mapping
+*
+* - parameter: 		pointer to mapped source file; pointer to databaseHeader; pointer to file array pointer (must be freed by the caller); pointer to number of loaded files
+*
+* - return value: 	error code, negative if out of memory
+******************************************************************
+*/
+int loadDirectory(mapfile_struct* sourceFile, databaseHeader_Struct* databaseHeader, file_struct*** filePtr, unsigned int* fileCNT)
+{
+	int error = 0;
+	uint32_t Address = 0;
+	file_struct** file = (file_struct**)calloc(databaseHeader->num_files + 1, sizeof(file_struct*));
+
+	*filePtr = file;
+	*fileCNT = 0;
+	if (file == NULL)
+	{
+		myPrint("Out of memory!\n");
+		return -1;
+	}
+
+	// Go to first file list
+	Address = databaseHeader->first_list;
+
+	for (unsigned int i = 0; i < databaseHeader->num_lists; i++)
+	{
+		file_list_struct* temp_fileList = NULL;
+
+		error |= decodefileList(sourceFile, Address, databaseHeader, &temp_fileList);
+		if (temp_fileList == NULL)
+		{
+			break;
+		}
+		Address += sizeof(file_list_struct);
 		
-		myPrint("    Total file size:\t[%d]\n", file[i]->data_size);
-		if(DuplicateTo == 0 || (linkLongLongFiles == 0 && noLongLongFiles == 0))
+		// Read in all files from this list
+		for (int j = 0; j < temp_fileList->file_cnt; j++)
+		{
+			file_struct* temp_file = NULL;
+
+			if (*fileCNT >= databaseHeader->num_files)
+			{
+				myPrint("file entry count mismatch! %d and %d\n", *fileCNT + 1, databaseHeader->num_files);
+				error |= 1;
+				break;
+			}
+
+			error |= decodefile(sourceFile, Address, &temp_file);
+			if (temp_file == NULL)
+			{
+				break;
+			}
+
+			*(file + *fileCNT) = temp_file;
+			Address += sizeof(file_struct);
+
+			(*fileCNT)++;
+		}
+
+		if (temp_fileList->next_file_list != 0)
+		{
+			// Go to next file list
+			Address = temp_fileList->next_file_list;
+		}
+		else
+		{
+			if (i + 1 != databaseHeader->num_lists)
+			{
+				myPrint("file size mismatch! %d and %d\n", i + 1, databaseHeader->num_lists);
+				error |= 1;
+			}
+			break;
+		}
+	}
+	if (*fileCNT != databaseHeader->num_files)
+	{
+		myPrint("file count mismatch! %d and %d\n", *fileCNT, databaseHeader->num_files);
+		error |= 1;
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	normalizeName()
+*
+* - description: 	Brings a file name into the form used by the name index: slashes only, no leading separator
+*
+* - parameter: 		pointer to name; length of name; destination (at least length bytes)
+*
+* - return value: 	length of normalized name
+******************************************************************
+*/
+unsigned int normalizeName(const char* name, unsigned int length, char* output)
+{
+	unsigned int outputLength = 0;
+	unsigned int i = 0;
+	while (i < length && (name[i] == DIR_SEPARATOR_WINDOWS || name[i] == DIR_SEPARATOR_UNIX))
+	{
+		i++; // Skip leading separators
+	}
+	for (; i < length && name[i] != '\0'; i++)
+	{
+		output[outputLength++] = (name[i] == DIR_SEPARATOR_WINDOWS) ? DIR_SEPARATOR_UNIX : name[i];
+	}
+	return outputLength;
+}
+
+/*
+******************************************************************
+* - function name:	decodefileList()
+*
+* - description: 	Read in, and print data file list. The list is referenced in place inside the mapping
+*
+* - parameter: 		pointer to mapped source file; address of the list; pointer to databaseHeader, pointer to fileList pointer
+*
+* - return value: 	error code
+******************************************************************
+*/
+int decodefileList(mapfile_struct* sourceFile, uint32_t Address, databaseHeader_Struct* databaseHeader, file_list_struct** fileListPtr)
+{
+	file_list_struct* fileList = mapfile_address(sourceFile, Address, sizeof(file_list_struct));
+	*fileListPtr = fileList;
+	if (fileList == NULL)
+	{
+		myPrint("File list at [%u] outside of database!\n", Address);
+		return 1;
+	}
+
+	// Check if counter match
+	if (fileList->file_cnt != fileList->file_cnt2)
+	{
+		myPrint("File counter mismatch! %d and %d \n", fileList->file_cnt, fileList->file_cnt2);
+		return 1;
+	}
+	// Check number of entries
+	if (fileList->file_cnt > 100)
+	{
+		myPrint("File counter to large! %d\n", fileList->file_cnt);
+		return 1;
+	}
+	// Check start code
+	if (fileList->magic != 0x6410)
+	{
+		myPrint("Startcode mismatch! %d\n", fileList->magic);
+		return 1;
+	}
+
+	// Check "always zeros"
+	for (int i = 0; i < 4; i++)
+	{
+		if (fileList->always_zero[i] != 0)
+		{
+			myPrint("always_zero[%d] in file entry header is not zero, but %d!\n", i, fileList->always_zero);
+		}
+	}
+	if (fileList->always_zero2 != 0)
+	{
+		myPrint("always_zero2 in file entry header is not zero, but %d!\n", fileList->always_zero2);
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	decodefile()
+*
+* - description: 	Read in file. The entry is referenced in place inside the mapping
+*
+* - parameter: 		pointer to mapped source file; address of the file entry; pointer to file pointer
+*
+* - return value: 	error code
+******************************************************************
+*/
+int decodefile(mapfile_struct* sourceFile, uint32_t Address, file_struct** filePtr)
+{
+	file_struct* file = mapfile_address(sourceFile, Address, sizeof(file_struct));
+	*filePtr = file;
+	if (file == NULL)
+	{
+		myPrint("File entry at [%u] outside of database!\n", Address);
+		return 1;
+	}
+
+	// Check address
+	if (Address != file->file_address)
+	{
+		myPrint("Address mismatch! %u and %u\n", Address, file->file_address);
+		return 1;
+	}
+
+	// Check filename length. The name is not terminated in the read only mapping, it is always used with its length
+	if (file->filename_length >= sizeof(file->filename) || file->filename_length == 0)
+	{
+		myPrint("Wrong filename length: [%d]\n", file->filename_length);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	exportFiles()
+*
+* - description: 	Export all files. The files are independent of each other, and are spread over numThreads workers.
+*					The log output of each file is collected and printed in directory order.
+*
+* - parameter: 		pointer to mapped source file; pointer to databaseHeader, pointer to file pointer; number of loaded files
+*
+* - return value: 	error code
+******************************************************************
+*/
+int exportFiles(mapfile_struct* sourceFile, databaseHeader_Struct* databaseHeader, file_struct** file, unsigned int numFiles)
+{
+	int error = 0;
+	export_struct Export = { 0 };
+
+	// Drop entries not selected by an include pattern before any payload is touched
+	if (includePatternCnt > 0)
+	{
+		unsigned int totalFiles = numFiles;
+		numFiles = selectFiles(file, numFiles);
+		myPrint("[%d] of [%d] entries selected by include pattern(s)\n\n", numFiles, totalFiles);
+	}
+
+	Export.sourceFile = sourceFile;
+	Export.file = file;
+	Export.numThreads = numThreads;
+	Export.EditTime = databaseHeader->edittime;
+	Export.Result = (export_result_struct*)calloc(numFiles + 1, sizeof(export_result_struct));
+	Export.Original = (file_struct**)calloc(numFiles + 1, sizeof(file_struct*));
+	Export.OriginalIndex = (unsigned int*)calloc(numFiles + 1, sizeof(unsigned int));
+	Export.InflaterCnt = max(numThreads, 1u);
+	Export.Inflater = (inflate_state_struct*)calloc(Export.InflaterCnt, sizeof(inflate_state_struct));
+	void* Index = hash_init(numFiles);
+	if (Export.Result == NULL || Export.Original == NULL || Export.OriginalIndex == NULL || Export.Inflater == NULL || Index == NULL)
+	{
+		myPrint("Out of memory!\n");
+		free(Export.Result);
+		free(Export.Original);
+		free(Export.OriginalIndex);
+		free(Export.Inflater);
+		hash_cleanup(&Index);
+		return 1;
+	}
+
+	// Index payload addresses once, so files sharing a payload are found in constant time
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		if (hash_insert(Index, &file[i]->data_address, sizeof(uint32_t), &file[i]) == 1)
+		{
+			file_struct** first = hash_lookup(Index, &file[i]->data_address, sizeof(uint32_t));
+			Export.Original[i] = *first;
+			Export.OriginalIndex[i] = (unsigned int)(first - file);
+		}
+	}
+	hash_cleanup(&Index);
+
+	// Files unchanged since the last extraction are not written again
+	if (updateFiles == 1 && noWriteFiles == 0)
+	{
+		char* ManifestPath = NULL;
+		uint32_t openingCounter = 0;
+		assemblePath(&ManifestPath, storepath, storepathLength, MANIFEST_NAME, sizeof(MANIFEST_NAME), '\0');
+		if (ManifestPath != NULL)
+		{
+			Export.Manifest = manifest_load(ManifestPath, nontDecompress, &openingCounter);
+		}
+		if (Export.Manifest != NULL)
+		{
+			myPrint("Updating previous extraction. The database was saved %d time(s) since.\n\n", databaseHeader->opening_counter - openingCounter);
+		}
+		else
+		{
+			myPrint("No usable manifest of a previous extraction found. Writing all files.\n\n");
+		}
+		free(ManifestPath);
+	}
+
+	if (noWriteFiles == 0)
+	{
+		createDirectories(file, numFiles);
+	}
+	// Without links the workers write the duplicates from the database, instead of copying them in directory order
+	dedupeCopies = dedupeFiles == 1 && noWriteFiles == 0 && probeDedupe() != 0;
+	if (dedupeCopies == 1)
+	{
+		myPrint("Destination supports no links. Writing double files as copies.\n\n");
+	}
+
+	// Let the operating system read the payloads in file order while the files are exported
+	prefetchFiles(&Export, numFiles);
+
+	int ownPool = 0;
+	if (writerBackend != WRITER_STDIO && noWriteFiles == 0)
+	{
+		createWriters(&Export);
+		// The kernel cancels the writes of a thread when it ends, so the threads are kept until the writers are done
+		ownPool = Export.Writer != NULL && workerpool_shared() == 0 && workerpool_start(numThreads) == 0 && workerpool_shared() == 1;
+	}
+	error = workerpool_run(numThreads, numFiles, exportJob, exportDone, &Export);
+	// Writes may still be in flight, a file is only complete once its writer is done
+	int writerError = finishWriters(&Export);
+	if (ownPool == 1)
+	{
+		workerpool_stop();
+	}
+	// Workers run ahead of the failed file. Their files are removed, so a failed run leaves the same files for any number of threads
+	if (error != 0)
+	{
+		unsigned int failed = 0;
+		while (failed < numFiles && Export.Result[failed].Error == 0)
+		{
+			failed++;
+		}
+		for (unsigned int i = failed + 1; i < numFiles; i++)
+		{
+			if (Export.Result[i].Written == 1)
+			{
+				removeFile(file[i]);
+			}
+		}
+	}
+	if (writerError != 0 && error == 0)
+	{
+		error = 1;
+	}
+	if (error == 0)
+	{
+		numExtractedFiles = numFiles;
+	}
+
+	if(Export.DuplicateCnt != 0 && error == 0)
+	{
+		myPrint("[%d] total duplicate file(s) found!\n", Export.DuplicateCnt);
+	}
+	if (verifyFiles == 1 && error == 0)
+	{
+		myPrint("[%d] of [%d] file(s) failed verification!\n", Export.CorruptCnt, numFiles);
+		error = Export.CorruptCnt != 0;
+	}
+	if (Export.Manifest != NULL && error == 0)
+	{
+		unsigned int SkippedCnt = 0;
+		for (unsigned int i = 0; i < numFiles; i++)
+		{
+			SkippedCnt += Export.Result[i].Skipped;
+		}
+		myPrint("[%d] unchanged file(s) skipped!\n", SkippedCnt);
+	}
+	if (noWriteFiles == 0 && error == 0)
+	{
+		writeManifest(&Export, databaseHeader, numFiles);
+	}
+	manifest_cleanup(&Export.Manifest);
+
+	// Logs and data of files finished after an error are dropped
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		free(Export.Result[i].Log);
+		free(Export.Result[i].Data);
+	}
+	for (unsigned int i = 0; i < Export.InflaterCnt; i++)
+	{
+		stateFree(&Export.Inflater[i]);
+	}
+	free(Export.Inflater);
+	free(Export.Result);
+	free(Export.Original);
+	free(Export.OriginalIndex);
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	prefetchFiles()
+*
+* - description: 	Collects the fragments of all files that will be read, sorts them by address and hands them
+*					to the operating system as few large ranges. The files are still exported in directory order,
+*					but the storage sees one sequential pass over the database instead of a seek per fragment
+*
+* - parameter: 		pointer to export struct; number of files
+*
+* - return value: 	-
+******************************************************************
+*/
+void prefetchFiles(export_struct* Export, unsigned int numFiles)
+{
+	unsigned int ExtentCnt = 0;
+	unsigned int ExtentSize = numFiles + 1;
+	read_extent_struct* Extent = malloc(ExtentSize * sizeof(read_extent_struct));
+	if (Extent == NULL)
+	{
+		return; // Prefetching is only a hint
+	}
+
+	// Walk the fragment headers. They are small, the payloads are not touched
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		file_struct* file = Export->file[i];
+		uint32_t next_fragment = file->data_address;
+		uint64_t payload_lengthAcc = 0;
+		uint64_t FragmentCnt = 0;
+		if (readsPayload(Export->Original[i]) == 0)
 		{
-			// Create and open destination file
-			FILE* destFile = myfopen("wb", storepath, storepathLength, file[i]->filename, file[i]->filename_length, 0);
-			if (destFile != 0)
+			continue; // Payload not read
+		}
+		do {
+			fragment_struct* fragment = mapfile_address(Export->sourceFile, next_fragment, sizeof(fragment_struct));
+			if (fragment == NULL)
+			{
+				break; // Reported by exportFile
+			}
+			if (ExtentCnt == ExtentSize)
 			{
-				// Allocate memory
-				Payload = (char*)malloc(file[i]->data_size);
-				if (Payload != 0)
+				read_extent_struct* newExtent = realloc(Extent, ExtentSize * 2 * sizeof(read_extent_struct));
+				if (newExtent == NULL)
 				{
-					payload_lengthAcc = 0;
-					fragment.next_fragment = file[i]->data_address;
-					FragmentCnt = 0;
-	
-					// Load file fragments
-					do {
-						fseek(sourceFile, fragment.next_fragment, SEEK_SET);
-						(void)!fread(&fragment, sizeof(fragment_struct), 1, sourceFile);
+					break;
+				}
+				Extent = newExtent;
+				ExtentSize *= 2;
+			}
+			Extent[ExtentCnt].Address = next_fragment;
+			Extent[ExtentCnt].Length = sizeof(fragment_struct) + fragment->payload_length;
+			ExtentCnt++;
+			payload_lengthAcc += fragment->payload_length;
+			next_fragment = fragment->next_fragment;
+		} while (next_fragment != 0 && payload_lengthAcc < file->data_size && ++FragmentCnt <= file->data_size);
+	}
 
-						// Read data if in range
-						if ((fragment.payload_length != 0) && ((fragment.payload_length + payload_lengthAcc) <= file[i]->data_size))
-						{
-							(void)!fread(Payload + payload_lengthAcc, sizeof(char), fragment.payload_length, sourceFile);
-						}
+	// Merge neighbouring fragments into sequential ranges
+	qsort(Extent, ExtentCnt, sizeof(read_extent_struct), compareExtent);
+	for (unsigned int i = 0; i < ExtentCnt;)
+	{
+		size_t Start = Extent[i].Address;
+		size_t End = Start + Extent[i].Length;
+		for (i++; i < ExtentCnt && Extent[i].Address <= End + PREFETCH_GAP; i++)
+		{
+			End = max(End, (size_t)Extent[i].Address + Extent[i].Length);
+		}
+		mapfile_prefetch(Export->sourceFile, Start, End - Start);
+	}
+	free(Extent);
+}
+
+/*
+******************************************************************
+* - function name:	createDirectories()
+*
+* - description: 	Creates the folders of all files once, before the files are exported.
+*					Thousands of files share a few folders, so the workers only have to open their files
+*					instead of creating every path component again for each file
+*
+* - parameter: 		pointer to file pointer; number of files
+*
+* - return value: 	-
+******************************************************************
+*/
+void createDirectories(file_struct** file, unsigned int numFiles)
+{
+	void* Created = hash_init(numFiles);
+	if (Created == NULL)
+	{
+		return; // Folders are created when the files are opened
+	}
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		char* Path = NULL;
+		uint32_t PathLength = assemblePath(&Path, storepath, storepathLength, file[i]->filename, file[i]->filename_length, '\0');
+		if (Path == NULL)
+		{
+			continue;
+		}
+		for (uint32_t j = 1; j < PathLength && Path[j] != '\0'; j++)
+		{
+			// Each folder is created once, with its parents before it
+			if (Path[j] == DIR_SEPARATOR && hash_insert(Created, Path, j, NULL) == 0)
+			{
+				Path[j] = '\0';
+				makeDirectory(Path);
+				Path[j] = DIR_SEPARATOR;
+			}
+		}
+		free(Path);
+	}
+	hash_cleanup(&Created);
+}
+
+/*
+******************************************************************
+* - function name:	createWriters()
+*
+* - description: 	Creates an io_uring writer for each worker thread. The files of a worker are opened, written and closed
+*					in batches by the kernel, while the worker already inflates the next files.
+*					Falls back to stdio if the kernel does not support it, or if duplicates are linked to complete files.
+*					Links are made in directory order by exportDone, the original has to be on disk by then
+*
+* - parameter: 		pointer to export struct
+*
+* - return value: 	-
+******************************************************************
+*/
+void createWriters(export_struct* Export)
+{
+	if ((dedupeFiles == 1 && dedupeCopies == 0) || (linkLongLongFiles == 1 && noLongLongFiles == 0))
+	{
+		myPrint("Linking double files needs complete files, using [%s] write backend.\n\n", writer_name(WRITER_STDIO));
+		return;
+	}
+	Export->Writer = (void**)calloc(Export->InflaterCnt, sizeof(void*));
+	for (unsigned int i = 0; Export->Writer != NULL && i < Export->InflaterCnt; i++)
+	{
+		Export->Writer[i] = writer_create();
+		if (Export->Writer[i] == NULL)
+		{
+			finishWriters(Export);
+		}
+	}
+	if (Export->Writer == NULL)
+	{
+		myPrint("Write backend [%s] is not available, using [%s].\n\n", writer_name(writerBackend), writer_name(WRITER_STDIO));
+	}
+}
+
+/*
+******************************************************************
+* - function name:	finishWriters()
+*
+* - description: 	Waits until all files of the io_uring writers are written and releases the writers
+*
+* - parameter: 		pointer to export struct
+*
+* - return value: 	number of files that could not be written completely
+******************************************************************
+*/
+int finishWriters(export_struct* Export)
+{
+	unsigned int Failed = 0;
+	if (Export->Writer == NULL)
+	{
+		return 0;
+	}
+	for (unsigned int i = 0; i < Export->InflaterCnt; i++)
+	{
+		if (Export->Writer[i] != NULL)
+		{
+			Failed += writer_finish(Export->Writer[i]);
+		}
+	}
+	free(Export->Writer);
+	Export->Writer = NULL;
+	if (Failed != 0)
+	{
+		myPrint("[%d] file(s) could not be written!\n", Failed);
+	}
+	return (int)Failed;
+}
+
+/*
+******************************************************************
+* - function name:	compareExtent()
+*
+* - description: 	Compare function for sorting fragments by address with qsort
+*
+* - parameter: 		pointers to the two extents
+*
+* - return value: 	-1, 0 or 1
+******************************************************************
+*/
+int compareExtent(const void* left, const void* right)
+{
+	uint32_t leftAddress = ((const read_extent_struct*)left)->Address;
+	uint32_t rightAddress = ((const read_extent_struct*)right)->Address;
+	return (leftAddress > rightAddress) - (leftAddress < rightAddress);
+}
+
+/*
+******************************************************************
+* - function name:	selectFiles()
+*
+* - description: 	Keeps only the files matching one of the include patterns. The file array is compacted in place
+*
+* - parameter: 		pointer to file pointer; number of loaded files
+*
+* - return value: 	number of selected files
+******************************************************************
+*/
+unsigned int selectFiles(file_struct** file, unsigned int numFiles)
+{
+	char Name[sizeof(((file_struct*)0)->filename)];
+	unsigned int selected = 0;
+
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		Name[normalizeName(file[i]->filename, file[i]->filename_length, Name)] = '\0';
+		for (unsigned int j = 0; j < includePatternCnt; j++)
+		{
+			if (matchPattern(includePattern[j], Name) == 1)
+			{
+				file[selected++] = file[i];
+				break;
+			}
+		}
+	}
+	return selected;
+}
+
+/*
+******************************************************************
+* - function name:	exportJob()
+*
+* - description: 	Worker job exporting a single file. Captures the log output when running multithreaded
+*
+* - parameter: 		pointer to export struct; file index
+*
+* - return value: 	-
+******************************************************************
+*/
+void exportJob(void* context, unsigned int i)
+{
+	export_struct* Export = (export_struct*)context;
+	unsigned int worker = workerpool_worker();
+	if (Export->numThreads > 1)
+	{
+		LogCaptureStart();
+	}
+	Export->Result[i].Error = exportFile(Export->sourceFile, Export->file[i], i, Export->Original[i], Export->Manifest,
+		worker < Export->InflaterCnt ? &Export->Inflater[worker] : NULL,
+		Export->Writer != NULL && worker < Export->InflaterCnt ? Export->Writer[worker] : NULL, &Export->Result[i]);
+	// Links and duplicates are made by exportDone, which stops at the failed file
+	Export->Result[i].Written = noWriteFiles == 0 && Export->Result[i].Skipped == 0 && readsPayload(Export->Original[i]) == 1;
+	if (Export->numThreads > 1)
+	{
+		Export->Result[i].LogLength = LogCaptureStop(&Export->Result[i].Log);
+	}
+}
+
+/*
+******************************************************************
+* - function name:	exportDone()
+*
+* - description: 	Called in directory order after a file was exported. Prints the captured log output, links duplicates
+*					to their original and hands the file content over to the tar archive and the in memory filesystem
+*
+* - parameter: 		pointer to export struct; file index
+*
+* - return value: 	error code of the file
+******************************************************************
+*/
+int exportDone(void* context, unsigned int i)
+{
+	export_struct* Export = (export_struct*)context;
+	LogWrite(Export->Result[i].Log, Export->Result[i].LogLength);
+	free(Export->Result[i].Log);
+	Export->Result[i].Log = NULL;
+	if (Export->Original[i] != NULL)
+	{
+		Export->DuplicateCnt++;
+	}
+	// Verification reports every file and continues after errors
+	if (verifyFiles == 1)
+	{
+		file_struct* file = Export->file[i];
+		fprintf(verifyFile != NULL ? verifyFile : stdout, "%s\t%08x\t%u\t%.*s\n", Export->Result[i].Error == 0 ? "OK" : "FAILED", Export->Result[i].Checksum,
+			(unsigned int)Export->Result[i].OutputSize, file->filename_length, file->filename);
+		Export->CorruptCnt += Export->Result[i].Error != 0;
+		return 0;
+	}
+	// Files are done in directory order, so the original is complete on disk by now
+	if (Export->Original[i] != NULL && linkLongLongFiles == 1 && noLongLongFiles == 0 && noWriteFiles == 0 && Export->Result[i].Error == 0)
+	{
+		file_struct* file = Export->file[i];
+		if (mylink(storepath, storepathLength, file->filename, file->filename_length, Export->Original[i]->filename, Export->Original[i]->filename_length) != 0)
+		{
+			myPrint("Failed to link [%.*s]!\n", file->filename_length, file->filename);
+			Export->Result[i].Error = 1;
+		}
+	}
+	else if (Export->Original[i] != NULL && dedupeFiles == 1 && readsPayload(Export->Original[i]) == 0 && noWriteFiles == 0 && Export->Result[i].Error == 0)
+	{
+		file_struct* file = Export->file[i];
+		if (mydedupe(storepath, storepathLength, file->filename, file->filename_length, Export->Original[i]->filename, Export->Original[i]->filename_length) != 0)
+		{
+			myPrint("Failed to deduplicate [%.*s]!\n", file->filename_length, file->filename);
+			Export->Result[i].Error = 1;
+		}
+	}
+	// Files are done in directory order, so the archive lists the entries like the database
+	if (tarFile != NULL && Export->Result[i].Error == 0)
+	{
+		file_struct* file = Export->file[i];
+		char Name[sizeof(file->filename)];
+		unsigned int NameLength = normalizeName(file->filename, file->filename_length, Name);
+		int error = 0;
+		if (readsPayload(Export->Original[i]) == 1)
+		{
+			error = tar_add(tarFile, Name, NameLength, Export->Result[i].Data, Export->Result[i].DataSize, Export->EditTime);
+		}
+		else if ((linkLongLongFiles == 1 && noLongLongFiles == 0) || dedupeFiles == 1)
+		{
+			char OriginalName[sizeof(file->filename)];
+			unsigned int OriginalNameLength = normalizeName(Export->Original[i]->filename, Export->Original[i]->filename_length, OriginalName);
+			error = tar_link(tarFile, Name, NameLength, OriginalName, OriginalNameLength, Export->EditTime);
+		}
+		if (error != 0)
+		{
+			myPrint("Failed to write [%.*s] to archive!\n", file->filename_length, file->filename);
+			Export->Result[i].Error = 1;
+		}
+		if (keepsInMemory(file) == 0)
+		{
+			free(Export->Result[i].Data); // Not needed by the parser, keep only the files in flight
+			Export->Result[i].Data = NULL;
+		}
+	}
+	// Skipped files and duplicates of files only on disk are read from disk by the parser
+	if (keepsInMemory(Export->file[i]) == 1 && Export->Result[i].Error == 0 && Export->Result[i].Skipped == 0 &&
+		(Export->Original[i] == NULL || (Export->Result[Export->OriginalIndex[i]].Skipped == 0 &&
+		(readsPayload(Export->Original[i]) == 1 || keepsInMemory(Export->Original[i]) == 1))))
+	{
+		file_struct* file = Export->file[i];
+		char* Path = NULL;
+		int error = 0;
+		assemblePath(&Path, storepath, storepathLength, file->filename, file->filename_length, '\0');
+		if (Path == NULL)
+		{
+			error = -1;
+		}
+		else if (readsPayload(Export->Original[i]) == 0)
+		{
+			char* OriginalPath = NULL;
+			assemblePath(&OriginalPath, storepath, storepathLength, Export->Original[i]->filename, Export->Original[i]->filename_length, '\0');
+			error = OriginalPath != NULL ? vfs_link(Path, OriginalPath) : -1;
+			free(OriginalPath);
+		}
+		else
+		{
+			error = vfs_add(Path, Export->Result[i].Data, Export->Result[i].DataSize);
+			if (error == 0)
+			{
+				Export->Result[i].Data = NULL; // Owned by the filesystem now
+			}
+		}
+		if (error < 0)
+		{
+			myPrint("Failed to keep [%.*s] in memory!\n", file->filename_length, file->filename);
+			Export->Result[i].Error = 1;
+		}
+		free(Path);
+	}
+	return Export->Result[i].Error;
+}
+
+/*
+******************************************************************
+* - function name:	exportFile()
+*
+* - description: 	Read in file payload and export a single file.
+*					The fragments are streamed from the mapping to the destination file and,
+*					if requested, into memory for the parser.
+*
+* - parameter: 		pointer to mapped source file; pointer to file; file index; pointer to first file with the same payload or NULL;
+*					manifest of the previous extraction or NULL; decompression state of the worker or NULL;
+*					io_uring writer of the worker or NULL; pointer to result
+*
+* - return value: 	error code
+******************************************************************
+*/
+int exportFile(mapfile_struct* sourceFile, file_struct* file, unsigned int i, file_struct* Original, void* Manifest, inflate_state_struct* State, void* Writer, export_result_struct* Result)
+{
+	export_stream_struct Stream;
+	fragment_struct* fragment = NULL;
+	uint32_t next_fragment = 0;
+	uint64_t payload_lengthAcc = 0; // Accumulate length of multiple fragments, 64 bit so broken lengths can not wrap around
+	unsigned int FragmentCnt = 0; // Count data fragments
+
+	myPrint("%d: reading % .*s \n", i + 1, file->filename_length, file->filename);
+	// Check if payload is allocated to multiple files
+	if (Original != NULL)
+	{
+		myPrint("    File is identical to: [%.*s]!\n", Original->filename_length, Original->filename);
+	}
 	
-						payload_lengthAcc += fragment.payload_length;
-						
-						FragmentCnt++;
-						// More than one data fragment
-						if (FragmentCnt > 1)
-						{
-							myPrint("    Data fragment %d loaded!\n", FragmentCnt);
-						}
-						
-						myPrint("    Fragment size:\t[%d]\n", fragment.payload_length);
-						
-						if (DuplicateTo != 0 && fragment.duplicates == 0 && FragmentCnt == 1)
-							// Duplicates are only checked on the first data fragment, to allow files with a mix of unique and shared fragments
-						{
-							myPrint("    Duplicate error!\n");
-							return 1;
-						}
-						
-						
-						// Repeat for each fragment
-						} while (fragment.next_fragment != 0 && payload_lengthAcc < file[i]->data_size);
-						
-					// Compression check
-					if (((uint8_t) * (Payload + 1) == 0xfd) &&
-						((uint8_t) * (Payload + 2) == 0xff) &&
-						((uint8_t) * (Payload + 3) == 0xff) &&
-						((uint8_t) * (Payload + 4) == 0x01) &&
-						nontDecompress == 0)
-					{
-						// Decompress file and write data
-						char* decompressedData;
-						int decompressedSize;
-						decompressedSize = decompress((Payload + 5), file[i]->data_size - 5, &decompressedData);
-						if (decompressedSize >= 1)
-						{
-							fwrite(decompressedData, sizeof(char), decompressedSize, destFile);
-							free(decompressedData);
-						}
-					}
-					else
-					{
-						// Just write data
-						fwrite(Payload, sizeof(char), file[i]->data_size, destFile);
-					}
-					if (payload_lengthAcc != file[i]->data_size)
+	myPrint("    GUID:\t\t");
+	printGUID(file->fileGUID);
+	myPrint("\n");
+	
+	myPrint("    Readable data:\t[");
+	for(int j = 0; j < 0x10; j++)
+	{
+		if(file->data[j] >= 32) // Printable characters
+		{
+			myPrint("%c", file->data[j]);
+		}
+		else // Control characters
+		{
+			myPrint(" 0x%02x ", file->data[j]);
+		}
+	}
+	myPrint("]\n");
+	
+	myPrint("    Total file size:\t[%u]\n", file->data_size);
+	if(readsPayload(Original) == 1)
+	{
+		if (Manifest != NULL && unchangedFile(Manifest, file) == 1)
+		{
+			myPrint("    Unchanged since the last extraction, skipping!\n\n");
+			Result->Skipped = 1;
+			return 0;
+		}
+
+		// Create and open destination file
+		FILE* destFile = NULL;
+		char WriteBuffer[WRITE_BUFFER_SIZE];
+		if (noWriteFiles == 1)
+		{
+			Writer = NULL;
+		}
+		else if (Writer == NULL)
+		{
+			destFile = openFile(file, WriteBuffer);
+		}
+		else if (openWriter(file, Writer) != 0)
+		{
+			Writer = NULL;
+		}
+		if (destFile != NULL || Writer != NULL || noWriteFiles == 1)
+		{
+			streamInit(&Stream, destFile, keepsInMemory(file) == 1 || tarFile != NULL, file->data_size);
+			Stream.Source = sourceFile;
+			Stream.Writer = Writer;
+			if (State != NULL)
+			{
+				Stream.State = State;
+			}
+			next_fragment = file->data_address;
+
+			// Stream file fragments to the destination file
+			do {
+				fragment = mapfile_address(sourceFile, next_fragment, sizeof(fragment_struct));
+				if (fragment == NULL)
+				{
+					myPrint("    Fragment at [%u] outside of database!\n", next_fragment);
+					streamClose(&Stream);
+					return 1;
+				}
+
+				// Use data if in range
+				if ((fragment->payload_length > 0) && ((fragment->payload_length + payload_lengthAcc) <= file->data_size))
+				{
+					uint8_t* FragmentData = mapfile_address(sourceFile, next_fragment + sizeof(fragment_struct), fragment->payload_length);
+					if (FragmentData == NULL)
 					{
-						myPrint("    Wrong filesize %d and %d!\n", payload_lengthAcc, file[i]->data_size);
+						myPrint("    Fragment data at [%u] outside of database!\n", next_fragment);
+						streamClose(&Stream);
 						return 1;
 					}
-					if(fragment.duplicates != 0)
-					{
-						myPrint("    Copies of data:\t[%d]\n", fragment.duplicates);
-					}
-					free(Payload);
+					streamWrite(&Stream, FragmentData, fragment->payload_length);
 				}
-				fclose(destFile);
-				myPrint("\n");
-			}
-			else
+
+				payload_lengthAcc += fragment->payload_length;
+				next_fragment = fragment->next_fragment;
+				
+				FragmentCnt++;
+				// More than one data fragment
+				if (FragmentCnt > 1)
+				{
+					myPrint("    Data fragment %d loaded!\n", FragmentCnt);
+				}
+				
+				myPrint("    Fragment size:\t[%u]\n", fragment->payload_length);
+				
+				if (Original != NULL && fragment->duplicates == 0 && FragmentCnt == 1)
+					// Duplicates are only checked on the first data fragment, to allow files with a mix of unique and shared fragments
+				{
+					myPrint("    Duplicate error!\n");
+					streamClose(&Stream);
+					return 1;
+				}
+				
+				
+				// Each used fragment holds at least one byte, more fragments can only come from a damaged chain
+				if (FragmentCnt > (uint64_t)file->data_size + 1)
+				{
+					myPrint("    Fragment chain does not end!\n");
+					streamClose(&Stream);
+					return 1;
+				}
+				
+				// Repeat for each fragment
+			} while (next_fragment != 0 && payload_lengthAcc < file->data_size);
+
+			if (payload_lengthAcc != file->data_size)
 			{
-				myPrint("writing % .*s failed!\n", file[i]->filename_length, file[i]->filename);
+				myPrint("    Wrong filesize %llu and %u!\n", (unsigned long long)payload_lengthAcc, file->data_size);
+				streamClose(&Stream);
 				return 1;
 			}
-		}
-		else if (linkLongLongFiles == 1 && noLongLongFiles == 0)
-		{ // Link
-			myPrint("    Linking file [%s] to file [%s]\n", file[i]->filename, file[DuplicateTo]->filename);
-			if(mylink(storepath, storepathLength, file[i]->filename, file[i]->filename_length, file[DuplicateTo]->filename, file[DuplicateTo]->filename_length) != 0)
+			streamFinish(&Stream, &Result->Data, &Result->DataSize);
+			Result->Checksum = Stream.Checksum;
+			Result->OutputSize = Stream.OutputSize;
+
+			// zlib checks the adler32 of each compressed payload when the end of the stream is reached
+			if (Stream.Error != 0 || (Stream.Compressed == 1 && Stream.Finished == 0))
 			{
+				myPrint("    Compressed data is damaged or incomplete!\n");
+				free(Result->Data);
+				Result->Data = NULL;
+				Result->DataSize = 0;
+				if (noWriteFiles == 0)
+				{
+					if (Writer != NULL)
+					{
+						writer_sync(Writer); // The file must be closed before it is removed
+					}
+					removeFile(file); // Do not leave a truncated file behind
+				}
 				return 1;
 			}
+
+			if(fragment->duplicates != 0)
+			{
+				myPrint("    Copies of data:\t[%u]\n", fragment->duplicates);
+			}
 			myPrint("\n");
 		}
-		else // (linkLongLongFiles == 0 && noLongLongFiles == 1)
+		else
+		{
+			myPrint("writing % .*s failed!\n", file->filename_length, file->filename);
+			return 1;
+		}
+	}
+	else if (linkLongLongFiles == 1 && noLongLongFiles == 0)
+	{ // Done by exportDone, once the original is complete
+		myPrint("    Linking file [%.*s] to file [%.*s]\n\n", file->filename_length, file->filename, Original->filename_length, Original->filename);
+	}
+	else if (dedupeFiles == 1)
+	{ // Done by exportDone, once the original is complete
+		myPrint("    Deduplicating file [%.*s] from file [%.*s]\n\n", file->filename_length, file->filename, Original->filename_length, Original->filename);
+	}
+	else // (linkLongLongFiles == 0 && noLongLongFiles == 1)
+	{
+		myPrint("    Skipping file!\n\n");
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	unchangedFile()
+*
+* - description: 	Checks if a file was already extracted with the same payload and is still present on disk
+*
+* - parameter: 		manifest of the previous extraction; pointer to file
+*
+* - return value: 	1 if the file does not need to be written, 0 otherwise
+******************************************************************
+*/
+int unchangedFile(void* Manifest, file_struct* file)
+{
+	char Name[sizeof(((file_struct*)0)->filename)];
+	char* Path = NULL;
+	FILE* existingFile = NULL;
+	unsigned int NameLength = normalizeName(file->filename, file->filename_length, Name);
+
+	if (manifest_unchanged(Manifest, Name, NameLength, file->fileGUID, file->data_size, file->data_address) == 0)
+	{
+		return 0;
+	}
+	assemblePath(&Path, storepath, storepathLength, file->filename, file->filename_length, '\0');
+	if (Path != NULL)
+	{
+		existingFile = fopen(Path, "rb");
+		free(Path);
+	}
+	if (existingFile == NULL)
+	{
+		return 0;
+	}
+	fclose(existingFile);
+	return 1;
+}
+
+/*
+******************************************************************
+* - function name:	writeManifest()
+*
+* - description: 	Stores GUID, size and payload address of all files present on disk next to the extracted tree,
+*					so the next run with updateFiles set only writes changed files
+*
+* - parameter: 		pointer to export struct; pointer to databaseHeader; number of files
+*
+* - return value: 	-
+******************************************************************
+*/
+void writeManifest(export_struct* Export, databaseHeader_Struct* databaseHeader, unsigned int numFiles)
+{
+	char Name[sizeof(((file_struct*)0)->filename)];
+	char* ManifestPath = NULL;
+	unsigned int entries = 0;
+
+	// Only regular files are listed, links and skipped duplicates are cheap to restore
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		entries += readsPayload(Export->Original[i]);
+	}
+	assemblePath(&ManifestPath, storepath, storepathLength, MANIFEST_NAME, sizeof(MANIFEST_NAME), '\0');
+	if (ManifestPath == NULL)
+	{
+		return;
+	}
+	FILE* manifestFile = manifest_create(ManifestPath, nontDecompress, databaseHeader->opening_counter, entries);
+	if (manifestFile == NULL)
+	{
+		myPrint("Failed to write [%s]!\n", ManifestPath);
+		free(ManifestPath);
+		return;
+	}
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		file_struct* file = Export->file[i];
+		if (readsPayload(Export->Original[i]) == 1)
 		{
-			myPrint("    Skipping file!\n\n");
+			manifest_add(manifestFile, Name, normalizeName(file->filename, file->filename_length, Name), file->fileGUID, file->data_size, file->data_address);
 		}
-		DuplicateTo = 0;
 	}
-	if(DuplicateCnt != 0)
+	if (manifest_close(manifestFile) != 0)
+	{
+		myPrint("Failed to write [%s]!\n", ManifestPath);
+	}
+	free(ManifestPath);
+}
+
+/*
+******************************************************************
+* - function name:	mapRead()
+*
+* - description: 	Copies data from the mapped file and advances the address
+*
+* - parameter: 		pointer to mapped source file; pointer to address; destination; number of bytes
+*
+* - return value: 	error code
+******************************************************************
+*/
+int mapRead(mapfile_struct* sourceFile, uint32_t* Address, void* destination, uint32_t length)
+{
+	void* source = mapfile_address(sourceFile, *Address, length);
+	if (source == NULL)
 	{
-		myPrint("[%d] total duplicate file(s) found!\n", DuplicateCnt);
+		return 1;
 	}
+	memcpy(destination, source, length);
+	*Address += length;
+	return 0;
+}
 
+/*
+******************************************************************
+* - function name:	mapReadString()
+*
+* - description: 	Reads a length prefixed string from the mapped file into a zero terminated copy
+*
+* - parameter: 		pointer to mapped source file; pointer to address; pointer to string length; pointer to string pointer
+*
+* - return value: 	error code
+******************************************************************
+*/
+int mapReadString(mapfile_struct* sourceFile, uint32_t* Address, uint32_t* length, char** string)
+{
+	*string = NULL;
+	if (mapRead(sourceFile, Address, length, sizeof(uint32_t)) != 0)
+	{
+		*length = 0;
+		return 1;
+	}
+	if (*length > 0)
+	{
+		char* source = mapfile_address(sourceFile, *Address, *length);
+		if (source == NULL)
+		{
+			return 1;
+		}
+		*string = malloc(*length + 1);
+		if (*string != 0)
+		{
+			memcpy(*string, source, *length);
+			*((*string) + *length) = '\0';
+		}
+		*Address += *length;
+	}
 	return 0;
 }
 
 /*
 ******************************************************************
-* - function name:	makePath()
+* - function name:	makePath()
+*
+* - description: 	Remove file ending from Database, Assemble & create filepath
+*
+* - parameter: 		pointer to first part; length of first part; pointer to second part; length of second part
+*
+* - return value: 	pointer to assembled path
+******************************************************************
+*/
+char* makePath(char* absolutepath, int absolutepathlength, char* filepath, int filepathlength)
+{
+	char* returnpath = NULL;
+	absolutepathlength -= 1; // Remove zero termination
+	// Remove .dat ending from database path if present
+	for (int i = 0; i < absolutepathlength - 3; i++)
+	{
+		if	(absolutepath[i] == '.' &&
+			(absolutepath[i + 1] == 'd' || absolutepath[i + 1] == 'D') &&
+			(absolutepath[i + 2] == 'a' || absolutepath[i + 2] == 'A') &&
+			(absolutepath[i + 3] == 't' || absolutepath[i + 3] == 'T'))
+		{
+			absolutepathlength = i;
+			break;
+		}
+	}
+	createPath(&returnpath, absolutepath, absolutepathlength, filepath, filepathlength, '\0');
+	return returnpath;
+}
+
+/*
+******************************************************************
+* - function name:	openFile()
+*
+* - description: 	Opens the destination file of an entry for writing. The folders are usually created
+*					by createDirectories already, the path is only created if opening fails
+*
+* - parameter: 		pointer to file; output buffer of WRITE_BUFFER_SIZE bytes, must stay valid until the file is closed
+*
+* - return value: 	filepointer or NULL on error
+******************************************************************
+*/
+FILE* openFile(file_struct* file, char* WriteBuffer)
+{
+	FILE* destFile = NULL;
+	char* Path = NULL;
+	assemblePath(&Path, storepath, storepathLength, file->filename, file->filename_length, '\0');
+	if (Path != NULL)
+	{
+		destFile = fopen(Path, "wb");
+		free(Path);
+	}
+	if (destFile == NULL)
+	{
+		destFile = myfopen("wb", storepath, storepathLength, file->filename, file->filename_length, 0);
+	}
+	if (destFile != NULL)
+	{
+		setvbuf(destFile, WriteBuffer, _IOFBF, WRITE_BUFFER_SIZE);
+	}
+	return destFile;
+}
+
+/*
+******************************************************************
+* - function name:	openWriter()
+*
+* - description: 	Starts the destination file of an entry on the io_uring writer of the worker.
+*					The open is only queued, a missing folder is reported when the writer is done
+*
+* - parameter: 		pointer to file; writer handle
+*
+* - return value: 	error code
+******************************************************************
+*/
+int openWriter(file_struct* file, void* Writer)
+{
+	char* Path = NULL;
+	int error = -1;
+	assemblePath(&Path, storepath, storepathLength, file->filename, file->filename_length, '\0');
+	if (Path != NULL)
+	{
+		error = writer_open(Writer, Path);
+		free(Path);
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	removeFile()
+*
+* - description: 	Deletes the destination file of a file entry
+*
+* - parameter: 		pointer to file
+*
+* - return value: 	-
+******************************************************************
+*/
+void removeFile(file_struct* file)
+{
+	char* Path = NULL;
+	assemblePath(&Path, storepath, storepathLength, file->filename, file->filename_length, '\0');
+	if (Path != NULL)
+	{
+		remove(Path);
+		free(Path);
+	}
+}
+
+/*
+******************************************************************
+* - function name:	mylink()
+*
+* - description: 	Assemble & create filepath, create link to existing file
+*
+* - parameter: 		pointer to first part; length of first part; pointer to source; length of source; pointer to destination; length of destination
+*
+* - return value: 	error code
+******************************************************************
+*/
+int mylink(char* absolutepath, int absolutepathlength, char* sourcepath, int sourcepathlength, char* destpath, int destpathlength)
+{
+	char* absolutesourcepath = makePath(absolutepath, absolutepathlength, sourcepath, sourcepathlength);
+	char* absolutedestpath = makePath(absolutepath, absolutepathlength, destpath, destpathlength);
+	int returnvalue = 1;
+	if (absolutesourcepath != 0 && absolutedestpath != 0)
+	{
+		#ifdef WIN32 // Building for Windows
+			remove(absolutesourcepath);
+			returnvalue = CreateSymbolicLinkA(absolutesourcepath, absolutedestpath, 0);
+			if(returnvalue == 0)
+			{
+				returnvalue = GetLastError();
+				myPrint("    Error [%d]!", returnvalue);
+				if(returnvalue == 1314) // Admin privileges required to create link
+				{
+					myPrint("Try to run the program as Administrator!");
+				}
+				myPrint("\n");
+			}
+			else
+			{
+				returnvalue = 0;
+			}
+		#else // Building for Unix
+			returnvalue = symlink(absolutesourcepath, absolutedestpath);
+		#endif
+		free(absolutesourcepath);
+		free(absolutedestpath);
+	}
+	return returnvalue;
+}
+
+/*
+******************************************************************
+* - function name:	mydedupe()
+*
+* - description: 	Assemble & create filepath, create a copy of an existing file without writing the data again.
+*					A reflink (copy on write clone, btrfs/xfs) is tried first, then a hardlink
+*
+* - parameter: 		pointer to first part; length of first part; pointer to new file; length of new file; pointer to existing file; length of existing file
+*
+* - return value: 	error code
+******************************************************************
+*/
+int mydedupe(char* absolutepath, int absolutepathlength, char* destpath, int destpathlength, char* sourcepath, int sourcepathlength)
+{
+	char* absolutedestpath = makePath(absolutepath, absolutepathlength, destpath, destpathlength);
+	char* absolutesourcepath = makePath(absolutepath, absolutepathlength, sourcepath, sourcepathlength);
+	int returnvalue = 1;
+	if (absolutesourcepath != 0 && absolutedestpath != 0)
+	{
+		remove(absolutedestpath);
+		#ifdef WIN32 // Building for Windows
+			if (CreateHardLinkA(absolutedestpath, absolutesourcepath, NULL) != 0)
+			{
+				returnvalue = 0;
+			}
+		#else // Building for Unix
+			#ifdef FICLONE
+				int Source = open(absolutesourcepath, O_RDONLY);
+				if (Source >= 0)
+				{
+					int Destination = open(absolutedestpath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+					if (Destination >= 0)
+					{
+						if (ioctl(Destination, FICLONE, Source) == 0)
+						{
+							returnvalue = 0;
+						}
+						close(Destination);
+						if (returnvalue != 0)
+						{
+							unlink(absolutedestpath);
+						}
+					}
+					close(Source);
+				}
+			#endif
+			if (returnvalue != 0 && link(absolutesourcepath, absolutedestpath) == 0)
+			{
+				returnvalue = 0;
+			}
+		#endif
+	}
+	free(absolutesourcepath);
+	free(absolutedestpath);
+	return returnvalue;
+}
+
+/*
+******************************************************************
+* - function name:	probeDedupe()
 *
-* - description: 	Remove file ending from Database, Assemble & create filepath
+* - description: 	Checks once per database if the destination supports reflinks or hardlinks
 *
-* - parameter: 		pointer to first part; length of first part; pointer to second part; length of second part
+* - parameter: 		-
 *
-* - return value: 	pointer to assembled path
+* - return value: 	error code, 0 if duplicates can be linked
 ******************************************************************
 */
-char* makePath(char* absolutepath, int absolutepathlength, char* filepath, int filepathlength)
+int probeDedupe(void)
 {
-	char* returnpath = NULL;
-	absolutepathlength -= 1; // Remove zero termination
-	// Remove .dat ending from database path if present
-	for (int i = 0; i < absolutepathlength - 3; i++)
+	char* ProbePath = makePath(storepath, storepathLength, DEDUPE_PROBE_NAME, sizeof(DEDUPE_PROBE_NAME));
+	FILE* probeFile = ProbePath != NULL ? fopen(ProbePath, "wb") : NULL;
+	int returnvalue = 1;
+	if (probeFile != NULL)
 	{
-		if	(absolutepath[i] == '.' &&
-			(absolutepath[i + 1] == 'd' || absolutepath[i + 1] == 'D') &&
-			(absolutepath[i + 2] == 'a' || absolutepath[i + 2] == 'A') &&
-			(absolutepath[i + 3] == 't' || absolutepath[i + 3] == 'T'))
+		fclose(probeFile);
+		returnvalue = mydedupe(storepath, storepathLength, DEDUPE_PROBE_LINK_NAME, sizeof(DEDUPE_PROBE_LINK_NAME), DEDUPE_PROBE_NAME, sizeof(DEDUPE_PROBE_NAME));
+		char* LinkPath = makePath(storepath, storepathLength, DEDUPE_PROBE_LINK_NAME, sizeof(DEDUPE_PROBE_LINK_NAME));
+		if (LinkPath != NULL)
 		{
-			absolutepathlength = i;
-			break;
+			remove(LinkPath);
+			free(LinkPath);
 		}
+		remove(ProbePath);
 	}
-	createPath(&returnpath, absolutepath, absolutepathlength, filepath, filepathlength, '\0');
-	return returnpath;
+	free(ProbePath);
+	return returnvalue;
 }
 
 /*
 ******************************************************************
-* - function name:	mylink()
+* - function name:	readsPayload()
 *
-* - description: 	Assemble & create filepath, create link to existing file
+* - description: 	Checks if the payload of a file is read and exported, or if the file is linked, deduplicated or skipped
 *
-* - parameter: 		pointer to first part; length of first part; pointer to source; length of source; pointer to destination; length of destination
+* - parameter: 		pointer to first file with the same payload or NULL
 *
-* - return value: 	error code
+* - return value: 	1 if the payload is read
 ******************************************************************
 */
-int mylink(char* absolutepath, int absolutepathlength, char* sourcepath, int sourcepathlength, char* destpath, int destpathlength)
+int readsPayload(file_struct* Original)
 {
-	char* absolutesourcepath = makePath(absolutepath, absolutepathlength, sourcepath, sourcepathlength);
-	char* absolutedestpath = makePath(absolutepath, absolutepathlength, destpath, destpathlength);
-	int returnvalue = 1;
-	if (absolutesourcepath != 0 && absolutedestpath != 0)
+	return Original == NULL || (linkLongLongFiles == 0 && noLongLongFiles == 0 && (dedupeFiles == 0 || dedupeCopies == 1));
+}
+
+/*
+******************************************************************
+* - function name:	keepsInMemory()
+*
+* - description: 	Checks if a file is kept in the in memory filesystem. Only the files opened by the parser are kept,
+*					unless nothing is written to disk the parser could read instead
+*
+* - parameter: 		pointer to file
+*
+* - return value: 	1 if the file is kept in memory
+******************************************************************
+*/
+int keepsInMemory(file_struct* file)
+{
+	char Name[sizeof(file->filename)];
+	if (memoryFiles == 0)
 	{
-		#ifdef WIN32 // Building for Windows
-			remove(absolutesourcepath);
-			returnvalue = CreateSymbolicLinkA(absolutesourcepath, absolutedestpath, 0);
-			if(returnvalue == 0)
-			{
-				returnvalue = GetLastError();
-				myPrint("    Error [%d]!", returnvalue);
-				if(returnvalue == 1314) // Admin privileges required to create link
-				{
-					myPrint("Try to run the program as Administrator!");
-				}
-				myPrint("\n");
-			}
-			else
-			{
-				returnvalue = 0;
-			}
-		#else // Building for Unix
-			returnvalue = symlink(absolutesourcepath, absolutedestpath);
-		#endif
-		free(absolutesourcepath);
-		free(absolutedestpath);
+		return 0;
 	}
-	return returnvalue;
+	if (noWriteFiles == 1)
+	{
+		return 1;
+	}
+	Name[normalizeName(file->filename, file->filename_length, Name)] = '\0';
+	return matchPattern(PARSER_CATALOG_PATTERN, Name) == 1 || matchPattern(PARSER_BLOCK_PATTERN, Name) == 1;
 }
 
 /*
@@ -804,95 +2340,426 @@ int mylink(char* absolutepath, int absolutepathlength, char* sourcepath, int sou
 ******************************************************************
 */
 void printGUID(uint8_t Guid[24])
+{
+	char Text[GUID_TEXT_SIZE];
+	formatGUID(Guid, Text);
+	myPrint("[%s]", Text);
+}
+
+/*
+******************************************************************
+* - function name:	formatGUID()
+*
+* - description: 	Decode GUID into text, matching the format in DXD logs
+*
+* - parameter: 		guid to decode; destination (GUID_TEXT_SIZE bytes)
+*
+* - return value: 	-
+******************************************************************
+*/
+void formatGUID(uint8_t Guid[24], char* Text)
 {
 	// Format: Byte 0-7 = First Part, Byte 8-15 = Third Part, Byte 16-23 Second Part. Value in hex with the nibbles of each byte swapped.
 	//						   (              First Part             ) [              Third Part             ] {              Second Part            }
 	// Consider the hex value: 0xDE 0xAD 0xC0 0xFE 0x01 0x23 0x45 0x67 0x89 0xAB 0xCD 0xEF 0xDE 0xAD 0xC0 0xFE 0x01 0x23 0x45 0x67 0x89 0xAB 0xCD 0xEF
 	// is decoded as: EDDA-0CEF-1032-5476-1032-5476-98BA-DCEF-98BA-DCEF-EDDA-0CEF
 	//				  (   First Part    ) {   Second Part   } [   Third Part    ]
+	static const size_t Order[12] = { 0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7 };
 	unsigned char temp1 = 0;
 	unsigned char temp2 = 0;
-	myPrint("[");
-	for (size_t i = 0; i < 4; i++)
-	{
-		// First 4 Byte
-		temp1 = swpnib(Guid[i << 1]);
-		temp2 = swpnib(Guid[(i << 1) + 1]);
-		myPrint("%02x%02x-", temp1, temp2);
-	}
-	for (size_t i = 8; i < 12; i++)
+	for (size_t i = 0; i < 12; i++)
 	{
-		// Next 4 Byte
-		temp1 = swpnib(Guid[i << 1]);
-		temp2 = swpnib(Guid[(i << 1) + 1]);
-		myPrint("%02x%02x-", temp1, temp2);
+		temp1 = swpnib(Guid[Order[i] << 1]);
+		temp2 = swpnib(Guid[(Order[i] << 1) + 1]);
+		Text += sprintf(Text, i < 11 ? "%02x%02x-" : "%02x%02x", temp1, temp2);
 	}
-	for (size_t i = 4; i < 8; i++)
+}
+
+/*
+******************************************************************
+* - function name:	countFragments()
+*
+* - description: 	Counts the fragments of a file by following the fragment headers, the payload is not read
+*
+* - parameter: 		pointer to mapped source file; pointer to file
+*
+* - return value: 	number of fragments, up to the first fragment outside of the database
+******************************************************************
+*/
+unsigned int countFragments(mapfile_struct* sourceFile, file_struct* file)
+{
+	uint32_t next_fragment = file->data_address;
+	uint64_t payload_lengthAcc = 0;
+	unsigned int FragmentCnt = 0;
+	do {
+		fragment_struct* fragment = mapfile_address(sourceFile, next_fragment, sizeof(fragment_struct));
+		if (fragment == NULL)
+		{
+			break;
+		}
+		payload_lengthAcc += fragment->payload_length;
+		next_fragment = fragment->next_fragment;
+	} while (++FragmentCnt <= file->data_size && next_fragment != 0 && payload_lengthAcc < file->data_size);
+	return FragmentCnt;
+}
+
+/*
+******************************************************************
+* - function name:	printJSON()
+*
+* - description: 	Prints a string as quoted and escaped JSON string
+*
+* - parameter: 		output stream; zero terminated string, NULL is printed as empty string
+*
+* - return value: 	-
+******************************************************************
+*/
+void printJSON(FILE* output, const char* text)
+{
+	fputc('"', output);
+	for (; text != NULL && *text != '\0'; text++)
 	{
-		// Last 4 Byte
-		temp1 = swpnib(Guid[i << 1]);
-		temp2 = swpnib(Guid[(i << 1) + 1]);
-		myPrint("%02x%02x", temp1, temp2);
-		if (i < 7)
+		unsigned char c = (unsigned char)*text;
+		if (c == '"' || c == '\\')
+		{
+			fputc('\\', output);
+			fputc(c, output);
+		}
+		else if (c < 0x20)
+		{
+			fprintf(output, "\\u%04x", c);
+		}
+		else
 		{
-			myPrint("-");
+			fputc(c, output);
 		}
 	}
-	myPrint("]");
+	fputc('"', output);
 }
 
 /*
 ******************************************************************
-* - function name:	decompress()
+* - function name:	streamInit()
 *
-* - description: 	Decompress and write data to file. Uses Zlib
+* - description: 	Prepares streaming a payload into a file and/or memory
 *
-* - parameter: 		pointer to data to decompress; pointer to data to decompress; filepointer to destination
+* - parameter: 		pointer to stream; destination file or NULL; 1 to keep the output in memory; total payload size
 *
-* - return value: 	error code
+* - return value: 	-
+******************************************************************
+*/
+void streamInit(export_stream_struct* stream, FILE* destFile, int KeepInMemory, uint32_t DataSize)
+{
+	memset(stream, 0, sizeof(export_stream_struct));
+	stream->destFile = destFile;
+	stream->KeepInMemory = KeepInMemory;
+	stream->DataSize = DataSize;
+	stream->State = &stream->Local;
+	// Only payloads with more than the header can be compressed
+	stream->Compressed = (DataSize > COMPRESSION_HEADER_SIZE && nontDecompress == 0) ? -1 : 0;
+}
+
+/*
+******************************************************************
+* - function name:	streamWrite()
+*
+* - description: 	Writes the next piece of a payload. The first bytes decide if the payload is compressed.
+*					Compressed data is inflated through a small buffer and written out right away,
+*					so memory use does not depend on the file size.
+*
+* - parameter: 		pointer to stream; pointer to data; length of data
+*
+* - return value: 	-
 ******************************************************************
 */
-int decompress(char* input, int InputSize, char** output)
+void streamWrite(export_stream_struct* stream, const uint8_t* data, uint32_t length)
 {
-	char Output[DECOMPRESS_CHUNK_SIZE];
-	z_stream ZStream;
-	ZStream.zalloc = Z_NULL;
-	ZStream.zfree = Z_NULL;
-	ZStream.opaque = Z_NULL;
-	ZStream.avail_in = InputSize;
-	ZStream.next_in = (unsigned char*)input;
-	int DecompressedSize = 0;
+	int Returnvalue = Z_OK;
+
+	// Collect compression header
+	while (stream->Compressed < 0 && length > 0)
+	{
+		stream->Header[stream->HeaderLength++] = *data++;
+		length--;
+		if (stream->HeaderLength == COMPRESSION_HEADER_SIZE)
+		{
+			// Compression check
+			if (stream->Header[1] == 0xfd && stream->Header[2] == 0xff && stream->Header[3] == 0xff && stream->Header[4] == 0x01)
+			{
+				if (stream->Quiet == 0)
+				{
+					myPrint("    Compressed file. decompressing...\n");
+				}
+				stream->Compressed = 1;
+				if (inflaterBackend != INFLATER_STREAM && length == stream->DataSize - COMPRESSION_HEADER_SIZE)
+				{
+					// The whole payload is in this fragment, inflate it with a single call
+					streamOneShot(stream, data, length);
+					return;
+				}
+				if (stateReady(stream->State) != 0)
+				{
+					myPrint("    Decompression Error:\t[%d]\n", Z_MEM_ERROR);
+					stream->Error = 1;
+				}
+			}
+			else
+			{
+				stream->Compressed = 0;
+				streamOutput(stream, stream->Header, stream->HeaderLength);
+			}
+		}
+	}
 
-	void* list = list_init();
-	myPrint("    Compressed file. decompressing...\n");
+	if (length == 0 || stream->Error != 0)
+	{
+		return;
+	}
 
-	// Init Decompression
-	inflateInit(&ZStream);
+	if (stream->Compressed == 0)
+	{
+		// Plain data only headed for disk is copied by the kernel, straight from the database file
+		if (stream->Source != NULL && stream->destFile != NULL && stream->KeepInMemory == 0 &&
+			mapfile_copy(stream->Source, (size_t)(data - stream->Source->Data), length, stream->destFile) == 0)
+		{
+			stream->OutputSize += length;
+			return;
+		}
+		// The mapping stays valid until the writer is done, so the kernel writes straight from it
+		if (stream->Source != NULL && stream->Writer != NULL && stream->KeepInMemory == 0)
+		{
+			writer_write(stream->Writer, data, length, 1);
+			stream->OutputSize += length;
+			return;
+		}
+		// Just write data
+		streamOutput(stream, data, length);
+		return;
+	}
 
-	// Decompress data in chunks
-	do
+	// Decompress data
+	z_stream* ZStream = &stream->State->ZStream;
+	ZStream->next_in = (unsigned char*)data;
+	ZStream->avail_in = length;
+	while (stream->Finished == 0)
 	{
-		ZStream.avail_out = DECOMPRESS_CHUNK_SIZE;
-		ZStream.next_out = (unsigned char*)&Output[0];
-		int Returnvalue = inflate(&ZStream, Z_NO_FLUSH);
+		ZStream->next_out = stream->State->Buffer;
+		ZStream->avail_out = DECOMPRESS_CHUNK_SIZE;
+		Returnvalue = inflate(ZStream, Z_NO_FLUSH);
 
 		//Error check
-		if (Returnvalue > 1)
+		if (Returnvalue != Z_OK && Returnvalue != Z_STREAM_END && Returnvalue != Z_BUF_ERROR)
 		{
 			myPrint("    Decompression Error:\t[%d]\n", Returnvalue);
-			return -1;
+			stream->Error = 1;
+			return;
+		}
+
+		streamOutput(stream, stream->State->Buffer, DECOMPRESS_CHUNK_SIZE - ZStream->avail_out);
+		stream->DecompressedSize += DECOMPRESS_CHUNK_SIZE - ZStream->avail_out;
+
+		if (Returnvalue == Z_STREAM_END)
+		{
+			stream->Finished = 1;
+		}
+		// Repeat until all input is used and no more output is pending
+		if (ZStream->avail_in == 0 && ZStream->avail_out != 0)
+		{
+			break;
+		}
+	}
+}
+
+/*
+******************************************************************
+* - function name:	streamOneShot()
+*
+* - description: 	Inflates a complete compressed payload with the selected one-shot backend
+*
+* - parameter: 		pointer to stream; pointer to compressed data after the compression header; length of data
+*
+* - return value: 	-
+******************************************************************
+*/
+void streamOneShot(export_stream_struct* stream, const uint8_t* data, uint32_t length)
+{
+	uint8_t* Output = NULL;
+	size_t OutputLength = 0;
+	if (inflater_oneshot(data, length, &Output, &OutputLength) != 0)
+	{
+		myPrint("    Decompression Error!\n");
+		stream->Error = 1;
+		return;
+	}
+	streamOutput(stream, Output, OutputLength);
+	stream->DecompressedSize = OutputLength;
+	stream->Finished = 1;
+	free(Output);
+}
+
+/*
+******************************************************************
+* - function name:	streamOutput()
+*
+* - description: 	Writes payload data to the destination file and/or memory
+*
+* - parameter: 		pointer to stream; pointer to data; length of data
+*
+* - return value: 	-
+******************************************************************
+*/
+void streamOutput(export_stream_struct* stream, const void* data, size_t length)
+{
+	if (verifyFiles == 1)
+	{
+		stream->Checksum = (uint32_t)crc32(stream->Checksum, data, (uInt)length);
+	}
+	stream->OutputSize += length;
+	if (stream->destFile != NULL)
+	{
+		fwrite(data, sizeof(char), length, stream->destFile);
+	}
+	else if (stream->Writer != NULL)
+	{
+		writer_write(stream->Writer, data, length, 0);
+	}
+	if (stream->KeepInMemory == 1 && stream->Error == 0 && length > 0)
+	{
+		if (stream->MemoryLength + length > stream->MemorySize)
+		{
+			// Start with the payload size, double if the data grows beyond it
+			size_t newSize = max(max(stream->MemorySize * 2, (size_t)stream->DataSize), stream->MemoryLength + length);
+			uint8_t* newMemory = (uint8_t*)realloc(stream->Memory, newSize);
+			if (newMemory == NULL)
+			{
+				myPrint("    Out of memory!\n");
+				stream->Error = 1;
+				return;
+			}
+			stream->Memory = newMemory;
+			stream->MemorySize = newSize;
 		}
+		memcpy(stream->Memory + stream->MemoryLength, data, length);
+		stream->MemoryLength += length;
+	}
+}
 
-		// Append data to list
-		list_append(list, &Output[0], (DECOMPRESS_CHUNK_SIZE - ZStream.avail_out));
+/*
+******************************************************************
+* - function name:	streamFinish()
+*
+* - description: 	Flushes the remaining data of a stream and releases it
+*
+* - parameter: 		pointer to stream; pointer to memory output (must be freed by the caller); pointer to memory output size
+*
+* - return value: 	-
+******************************************************************
+*/
+void streamFinish(export_stream_struct* stream, uint8_t** Memory, size_t* MemoryLength)
+{
+	if (stream->Compressed < 0 && stream->HeaderLength > 0)
+	{
+		// Payload too short for the compression check
+		streamOutput(stream, stream->Header, stream->HeaderLength);
+	}
+	else if (stream->Compressed == 1 && stream->Error == 0 && stream->Quiet == 0)
+	{
+		myPrint("    Decompressed size:\t[%zu]\n", stream->DecompressedSize);
+	}
+	if (stream->Error == 0)
+	{
+		// Hand over memory output
+		*Memory = stream->Memory;
+		*MemoryLength = stream->MemoryLength;
+		stream->Memory = NULL;
+	}
+	streamClose(stream);
+}
 
-		// Reperat until end of file
-	} while (ZStream.avail_out == 0);
+/*
+******************************************************************
+* - function name:	streamClose()
+*
+* - description: 	Releases a stream without flushing it and closes the destination file
+*
+* - parameter: 		pointer to stream
+*
+* - return value: 	-
+******************************************************************
+*/
+void streamClose(export_stream_struct* stream)
+{
+	if (stream->State == &stream->Local)
+	{
+		stateFree(&stream->Local); // Worker states are kept for the next file
+	}
+	if (stream->destFile != NULL)
+	{
+		fclose(stream->destFile);
+		stream->destFile = NULL;
+	}
+	if (stream->Writer != NULL)
+	{
+		writer_close(stream->Writer); // Only queued, the writer closes the file once its writes are done
+		stream->Writer = NULL;
+	}
+	free(stream->Memory);
+	stream->Memory = NULL;
+}
 
-	DecompressedSize = list_to_memblk(list, (void**)output);
-	list_cleanup(&list);
-	myPrint("    Decompressed size:\t[%d]\n", DecompressedSize);
-	inflateEnd(&ZStream); // Just in case
+/*
+******************************************************************
+* - function name:	stateReady()
+*
+* - description: 	Prepares a decompression state for the next payload. The buffer and the zlib state are
+*					allocated on first use and only reset afterwards, so small files do not pay the setup cost
+*
+* - parameter: 		pointer to decompression state
+*
+* - return value: 	error code
+******************************************************************
+*/
+int stateReady(inflate_state_struct* state)
+{
+	if (state->Buffer == NULL)
+	{
+		state->Buffer = (unsigned char*)malloc(DECOMPRESS_CHUNK_SIZE);
+		if (state->Buffer == NULL)
+		{
+			return -1;
+		}
+	}
+	if (state->Initialized == 1)
+	{
+		return inflateReset(&state->ZStream) != Z_OK;
+	}
+	memset(&state->ZStream, 0, sizeof(z_stream));
+	if (inflateInit(&state->ZStream) != Z_OK)
+	{
+		return -1;
+	}
+	state->Initialized = 1;
+	return 0;
+}
 
-	return DecompressedSize;
-}
\ No newline at end of file
+/*
+******************************************************************
+* - function name:	stateFree()
+*
+* - description: 	Releases a decompression state
+*
+* - parameter: 		pointer to decompression state
+*
+* - return value: 	-
+******************************************************************
+*/
+void stateFree(inflate_state_struct* state)
+{
+	if (state->Initialized == 1)
+	{
+		inflateEnd(&state->ZStream);
+		state->Initialized = 0;
+	}
+	free(state->Buffer);
+	state->Buffer = NULL;
+}
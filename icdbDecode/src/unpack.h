@@ -9,6 +9,23 @@
 #ifndef _UNPACK_H
 #define _UNPACK_H
 
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for file type
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define LIST_TSV 1		// Listing as tab separated table, header as comment lines
+#define LIST_JSON 2		// Listing as JSON object
+
 /*
 ******************************************************************
 * Global Variables
@@ -17,6 +34,17 @@
 extern int nontDecompress;
 extern int linkLongLongFiles;
 extern int noLongLongFiles;
+extern int dedupeFiles;
+extern int memoryFiles;
+extern int noWriteFiles;
+extern unsigned int numThreads;
+extern char** includePattern;
+extern unsigned int includePatternCnt;
+extern unsigned int numExtractedFiles;
+extern int updateFiles;
+extern FILE* tarFile;
+extern int verifyFiles;
+extern FILE* verifyFile;
 
 /*
 ******************************************************************
@@ -24,5 +52,13 @@ extern int noLongLongFiles;
 ******************************************************************
 */
 extern int UnpackIcdb(char*, int, char*, int);
+extern void* icdb_open(char*);
+extern void* icdb_lookup(void*, char*);
+extern void* icdb_entry(void*, unsigned int);
+extern int icdb_read(void*, void*, uint8_t**, size_t*);
+extern void icdb_close(void**);
+extern int ListIcdb(char*, int, char*, FILE*);
+extern int addIncludePattern(char*);
+extern void freeIncludePatterns(void);
 
 #endif //_UNPACK_H
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "vfs.h"
+#include <stdio.h>		// Required for fmemopen, tmpfile
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for strlen
+#include "hash.h"		// Required for hash_init
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define VFS_EXPECTED_FILES 1024 // Initial size of the path index
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct vfs_file_struct
+{
+	uint8_t* Data;		// File content
+	size_t Size;		// Size of file content
+	int Link;			// Content belongs to another file
+}vfs_file_struct;
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+void* vfsIndex = NULL; // Path -> vfs_file_struct
+vfs_file_struct** vfsFiles = NULL; // All files, needed for cleanup
+unsigned int vfsFilesCnt = 0;
+unsigned int vfsFilesSize = 0;
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+int vfs_store(char*, vfs_file_struct*);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	vfs_add()
+*
+* - description: 	Adds a file to the in memory filesystem. Takes ownership of the data
+*
+* - parameter: 		complete file path; file content (allocated with malloc); size of file content
+*
+* - return value: 	0 if added, 1 if the path already exists, -1 on error
+******************************************************************
+*/
+int vfs_add(char* path, uint8_t* data, size_t size)
+{
+	vfs_file_struct* file = calloc(1, sizeof(vfs_file_struct));
+	if (file == NULL)
+	{
+		return -1;
+	}
+	file->Data = data;
+	file->Size = size;
+	int error = vfs_store(path, file);
+	if (error != 0)
+	{
+		free(file); // Data stays with the caller
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	vfs_link()
+*
+* - description: 	Adds a file sharing the content of a file already in the in memory filesystem
+*
+* - parameter: 		complete file path; complete path of the original file
+*
+* - return value: 	0 if added, 1 if the path already exists, -1 on error
+******************************************************************
+*/
+int vfs_link(char* path, char* original)
+{
+	vfs_file_struct* source = hash_lookup(vfsIndex, original, (unsigned int)strlen(original));
+	if (source == NULL)
+	{
+		return -1;
+	}
+	vfs_file_struct* file = calloc(1, sizeof(vfs_file_struct));
+	if (file == NULL)
+	{
+		return -1;
+	}
+	file->Data = source->Data;
+	file->Size = source->Size;
+	file->Link = 1;
+	int error = vfs_store(path, file);
+	if (error != 0)
+	{
+		free(file);
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	vfs_fopen()
+*
+* - description: 	Opens a file of the in memory filesystem for reading
+*
+* - parameter: 		complete file path
+*
+* - return value: 	filepointer or NULL if the file is not in memory
+******************************************************************
+*/
+FILE* vfs_fopen(char* path)
+{
+	FILE* returnfile = NULL;
+	vfs_file_struct* file = hash_lookup(vfsIndex, path, (unsigned int)strlen(path));
+	if (file == NULL)
+	{
+		return NULL;
+	}
+#ifndef WIN32 // Building for Unix
+	if (file->Size > 0)
+	{
+		return fmemopen(file->Data, file->Size, "rb"); // Reads straight from the stored buffer
+	}
+#endif
+	// No memory streams available (or empty file). Go through a temporary file
+	returnfile = tmpfile();
+	if (returnfile != NULL)
+	{
+		if (fwrite(file->Data, sizeof(uint8_t), file->Size, returnfile) != file->Size)
+		{
+			fclose(returnfile);
+			return NULL;
+		}
+		rewind(returnfile);
+	}
+	return returnfile;
+}
+
+/*
+******************************************************************
+* - function name:	vfs_data()
+*
+* - description: 	Gives direct access to the content of a file of the in memory filesystem, nothing is copied.
+*					The content stays valid until vfs_cleanup() is called
+*
+* - parameter: 		complete file path; pointer to data pointer; pointer to data size
+*
+* - return value: 	0 if found, -1 if the file is not in memory
+******************************************************************
+*/
+int vfs_data(char* path, uint8_t** data, size_t* size)
+{
+	vfs_file_struct* file = hash_lookup(vfsIndex, path, (unsigned int)strlen(path));
+	if (file == NULL)
+	{
+		return -1;
+	}
+	*data = file->Data;
+	*size = file->Size;
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	vfs_cleanup()
+*
+* - description: 	Removes all files from the in memory filesystem
+*
+* - parameter: 		-
+*
+* - return value: 	-
+******************************************************************
+*/
+void vfs_cleanup(void)
+{
+	for (unsigned int i = 0; i < vfsFilesCnt; i++)
+	{
+		if (vfsFiles[i]->Link == 0)
+		{
+			free(vfsFiles[i]->Data);
+		}
+		free(vfsFiles[i]);
+	}
+	free(vfsFiles);
+	vfsFiles = NULL;
+	vfsFilesCnt = 0;
+	vfsFilesSize = 0;
+	hash_cleanup(&vfsIndex);
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	vfs_store()
+*
+* - description: 	Adds a file to the path index
+*
+* - parameter: 		complete file path; file
+*
+* - return value: 	0 if added, 1 if the path already exists, -1 on error
+******************************************************************
+*/
+int vfs_store(char* path, vfs_file_struct* file)
+{
+	if (vfsIndex == NULL)
+	{
+		vfsIndex = hash_init(VFS_EXPECTED_FILES);
+		if (vfsIndex == NULL)
+		{
+			return -1;
+		}
+	}
+	if (vfsFilesCnt == vfsFilesSize)
+	{
+		unsigned int newSize = vfsFilesSize == 0 ? VFS_EXPECTED_FILES : vfsFilesSize * 2;
+		vfs_file_struct** newFiles = realloc(vfsFiles, newSize * sizeof(vfs_file_struct*));
+		if (newFiles == NULL)
+		{
+			return -1;
+		}
+		vfsFiles = newFiles;
+		vfsFilesSize = newSize;
+	}
+	int error = hash_insert(vfsIndex, path, (unsigned int)strlen(path), file);
+	if (error == 0)
+	{
+		vfsFiles[vfsFilesCnt++] = file;
+	}
+	return error;
+}
@@ -0,0 +1,39 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _VFS_H
+#define _VFS_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for file type
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern int vfs_add(char*, uint8_t*, size_t);
+extern int vfs_link(char*, char*);
+extern FILE* vfs_fopen(char*);
+extern int vfs_data(char*, uint8_t**, size_t*);
+extern void vfs_cleanup(void);
+
+#endif //_VFS_H
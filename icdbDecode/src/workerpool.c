@@ -0,0 +1,505 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "workerpool.h"
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+
+#ifdef WIN32 // Building for Windows
+	#include <windows.h>	// Required for CreateThread, CONDITION_VARIABLE
+#else // Building for Unix
+	#include <pthread.h>	// Required for pthread_create
+	#include <unistd.h>		// Required for sysconf
+#endif
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#ifdef WIN32 // Building for Windows
+	#define POOL_LOCK(pool)		EnterCriticalSection(&(pool)->Lock)
+	#define POOL_UNLOCK(pool)	LeaveCriticalSection(&(pool)->Lock)
+	#define POOL_WAIT(cond, pool)	SleepConditionVariableCS(&(cond), &(pool)->Lock, INFINITE)
+	#define POOL_WAKE(cond)		WakeAllConditionVariable(&(cond))
+#else // Building for Unix
+	#define POOL_LOCK(pool)		pthread_mutex_lock(&(pool)->Lock)
+	#define POOL_UNLOCK(pool)	pthread_mutex_unlock(&(pool)->Lock)
+	#define POOL_WAIT(cond, pool)	pthread_cond_wait(&(cond), &(pool)->Lock)
+	#define POOL_WAKE(cond)		pthread_cond_broadcast(&(cond))
+#endif
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+typedef struct workerpool_struct
+{
+	void(*Job)(void*, unsigned int);	// Job function, called from the worker threads
+	void* Context;						// User data for the job function
+	unsigned int NumJobs;				// Total number of jobs
+	unsigned int NextJob;				// Next job to hand out
+	unsigned int Completed;				// Number of jobs handed to the done function
+	unsigned int Window;				// Maximum number of jobs running ahead of Completed
+	int Abort;							// Stop handing out jobs
+	uint8_t* Finished;					// Finished flag for each job
+	unsigned int NumThreads;			// Number of running threads
+	unsigned int Busy;					// Number of threads working on the current run
+	unsigned int Run;					// Incremented for every run, wakes up the idle threads
+	unsigned int Started;				// Number of threads that picked their worker number
+	int Shutdown;						// Threads exit
+#ifdef WIN32 // Building for Windows
+	HANDLE* Threads;
+	CRITICAL_SECTION Lock;
+	CONDITION_VARIABLE JobFinished;
+	CONDITION_VARIABLE SlotFree;
+	CONDITION_VARIABLE WorkReady;
+	CONDITION_VARIABLE Idle;
+#else // Building for Unix
+	pthread_t* Threads;
+	pthread_mutex_t Lock;
+	pthread_cond_t JobFinished;
+	pthread_cond_t SlotFree;
+	pthread_cond_t WorkReady;
+	pthread_cond_t Idle;
+#endif
+} workerpool_struct;
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+workerpool_struct* sharedPool = NULL; // Pool kept alive between runs, see workerpool_start()
+THREAD_LOCAL unsigned int workerNumber = 0; // Number of the calling worker thread, see workerpool_worker()
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+workerpool_struct* workerpool_create(unsigned int);
+void workerpool_destroy(workerpool_struct*);
+#ifdef WIN32 // Building for Windows
+DWORD WINAPI workerpool_thread(LPVOID);
+#else // Building for Unix
+void* workerpool_thread(void*);
+#endif
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	workerpool_run()
+*
+* - description: 	Runs a number of independent jobs on a pool of threads.
+*					The done function is called on the calling thread, strictly in job order,
+*					so output generated there stays deterministic. If it returns a value other than 0,
+*					no further jobs are started. With one thread everything runs inline.
+*					If a shared pool was started with workerpool_start(), its threads are used,
+*					otherwise threads are created for this run only.
+*
+* - parameter: 		number of threads; number of jobs; job function; done function; user data
+*
+* - return value: 	first error code returned by the done function
+******************************************************************
+*/
+int workerpool_run(unsigned int numThreads, unsigned int numJobs, void(*Job)(void*, unsigned int), int(*Done)(void*, unsigned int), void* context)
+{
+	int error = 0;
+	workerpool_struct* pool = sharedPool;
+
+	if (pool == NULL && numThreads > numJobs)
+	{
+		numThreads = numJobs;
+	}
+
+	// Single threaded
+	if (numThreads <= 1 || numJobs <= 1)
+	{
+		for (unsigned int i = 0; i < numJobs && error == 0; i++)
+		{
+			Job(context, i);
+			error = Done(context, i);
+		}
+		return error;
+	}
+
+	if (pool == NULL)
+	{
+		pool = workerpool_create(numThreads);
+	}
+	uint8_t* Finished = calloc(numJobs, sizeof(uint8_t));
+	if (pool == NULL || Finished == NULL) // No threads available. Work inline
+	{
+		for (unsigned int i = 0; i < numJobs && error == 0; i++)
+		{
+			Job(context, i);
+			error = Done(context, i);
+		}
+		free(Finished);
+		if (pool != sharedPool)
+		{
+			workerpool_destroy(pool);
+		}
+		return error;
+	}
+
+	// Hand the jobs to the idle threads
+	POOL_LOCK(pool);
+	pool->Job = Job;
+	pool->Context = context;
+	pool->NumJobs = numJobs;
+	pool->NextJob = 0;
+	pool->Completed = 0;
+	pool->Window = pool->NumThreads * WORKERPOOL_WINDOW;
+	pool->Abort = 0;
+	pool->Finished = Finished;
+	pool->Busy = pool->NumThreads;
+	pool->Run++;
+	POOL_WAKE(pool->WorkReady);
+	POOL_UNLOCK(pool);
+
+	// Collect results in order
+	for (unsigned int i = 0; i < numJobs; i++)
+	{
+		POOL_LOCK(pool);
+		while (pool->Finished[i] == 0)
+		{
+			POOL_WAIT(pool->JobFinished, pool);
+		}
+		POOL_UNLOCK(pool);
+
+		error = Done(context, i);
+
+		POOL_LOCK(pool);
+		pool->Completed = i + 1;
+		if (error != 0)
+		{
+			pool->Abort = 1;
+		}
+		POOL_WAKE(pool->SlotFree);
+		POOL_UNLOCK(pool);
+
+		if (error != 0)
+		{
+			break;
+		}
+	}
+
+	// Wait until all threads left this run
+	POOL_LOCK(pool);
+	while (pool->Busy > 0)
+	{
+		POOL_WAIT(pool->Idle, pool);
+	}
+	pool->Finished = NULL;
+	POOL_UNLOCK(pool);
+	free(Finished);
+
+	if (pool != sharedPool)
+	{
+		workerpool_destroy(pool);
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_start()
+*
+* - description: 	Starts a shared pool. Its threads stay alive and are used by all following
+*					calls of workerpool_run(), until workerpool_stop() is called
+*
+* - parameter: 		number of threads
+*
+* - return value: 	error code
+******************************************************************
+*/
+int workerpool_start(unsigned int numThreads)
+{
+	if (sharedPool != NULL)
+	{
+		return 0;
+	}
+	if (numThreads <= 1)
+	{
+		return 0; // Everything runs inline anyway
+	}
+	sharedPool = workerpool_create(numThreads);
+	return sharedPool != NULL ? 0 : -1;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_stop()
+*
+* - description: 	Ends the threads of the shared pool
+*
+* - parameter: 		-
+*
+* - return value: 	-
+******************************************************************
+*/
+void workerpool_stop(void)
+{
+	workerpool_destroy(sharedPool);
+	sharedPool = NULL;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_shared()
+*
+* - description: 	Tells if a shared pool is running, so callers only stop a pool they started themselves
+*
+* - parameter: 		-
+*
+* - return value: 	1 if a shared pool is running, 0 otherwise
+******************************************************************
+*/
+int workerpool_shared(void)
+{
+	return sharedPool != NULL;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_cpus()
+*
+* - description: 	Returns the number of available processors
+*
+* - parameter: 		-
+*
+* - return value: 	number of processors, at least 1
+******************************************************************
+*/
+unsigned int workerpool_cpus(void)
+{
+	long cpus = 1;
+#ifdef WIN32 // Building for Windows
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	cpus = info.dwNumberOfProcessors;
+#else // Building for Unix
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (cpus < 1)
+	{
+		cpus = 1;
+	}
+	return (unsigned int)cpus;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_worker()
+*
+* - description: 	Returns the number of the worker thread running the calling job.
+*					Jobs can use it to reuse per worker resources without locking.
+*					Jobs running inline on the calling thread get 0
+*
+* - parameter: 		-
+*
+* - return value: 	worker number, smaller than the number of threads of the pool
+******************************************************************
+*/
+unsigned int workerpool_worker(void)
+{
+	return workerNumber;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	workerpool_create()
+*
+* - description: 	Creates a pool of idle threads
+*
+* - parameter: 		number of threads
+*
+* - return value: 	pointer to pool or NULL if no thread could be started
+******************************************************************
+*/
+workerpool_struct* workerpool_create(unsigned int numThreads)
+{
+	workerpool_struct* pool = calloc(1, sizeof(workerpool_struct));
+	if (pool == NULL)
+	{
+		return NULL;
+	}
+#ifdef WIN32 // Building for Windows
+	pool->Threads = calloc(numThreads, sizeof(HANDLE));
+	InitializeCriticalSection(&pool->Lock);
+	InitializeConditionVariable(&pool->JobFinished);
+	InitializeConditionVariable(&pool->SlotFree);
+	InitializeConditionVariable(&pool->WorkReady);
+	InitializeConditionVariable(&pool->Idle);
+	for (unsigned int i = 0; pool->Threads != NULL && i < numThreads; i++)
+	{
+		pool->Threads[pool->NumThreads] = CreateThread(NULL, 0, workerpool_thread, pool, 0, NULL);
+		if (pool->Threads[pool->NumThreads] != NULL)
+		{
+			pool->NumThreads++;
+		}
+	}
+#else // Building for Unix
+	pool->Threads = calloc(numThreads, sizeof(pthread_t));
+	pthread_mutex_init(&pool->Lock, NULL);
+	pthread_cond_init(&pool->JobFinished, NULL);
+	pthread_cond_init(&pool->SlotFree, NULL);
+	pthread_cond_init(&pool->WorkReady, NULL);
+	pthread_cond_init(&pool->Idle, NULL);
+	for (unsigned int i = 0; pool->Threads != NULL && i < numThreads; i++)
+	{
+		if (pthread_create(&pool->Threads[pool->NumThreads], NULL, workerpool_thread, pool) == 0)
+		{
+			pool->NumThreads++;
+		}
+	}
+#endif
+	if (pool->NumThreads == 0)
+	{
+		workerpool_destroy(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_destroy()
+*
+* - description: 	Ends all threads of a pool and releases it
+*
+* - parameter: 		pointer to pool
+*
+* - return value: 	-
+******************************************************************
+*/
+void workerpool_destroy(workerpool_struct* pool)
+{
+	if (pool == NULL)
+	{
+		return;
+	}
+	POOL_LOCK(pool);
+	pool->Shutdown = 1;
+	POOL_WAKE(pool->WorkReady);
+	POOL_UNLOCK(pool);
+
+	// Wait for all threads
+	for (unsigned int i = 0; i < pool->NumThreads; i++)
+	{
+#ifdef WIN32 // Building for Windows
+		WaitForSingleObject(pool->Threads[i], INFINITE);
+		CloseHandle(pool->Threads[i]);
+#else // Building for Unix
+		pthread_join(pool->Threads[i], NULL);
+#endif
+	}
+
+#ifdef WIN32 // Building for Windows
+	DeleteCriticalSection(&pool->Lock);
+#else // Building for Unix
+	pthread_cond_destroy(&pool->Idle);
+	pthread_cond_destroy(&pool->WorkReady);
+	pthread_cond_destroy(&pool->SlotFree);
+	pthread_cond_destroy(&pool->JobFinished);
+	pthread_mutex_destroy(&pool->Lock);
+#endif
+	free(pool->Threads);
+	free(pool);
+}
+
+/*
+******************************************************************
+* - function name:	workerpool_thread()
+*
+* - description: 	Worker thread. Waits for a run, then picks up jobs until all are handed out or the run is aborted
+*
+* - parameter: 		pointer to pool
+*
+* - return value: 	-
+******************************************************************
+*/
+#ifdef WIN32 // Building for Windows
+DWORD WINAPI workerpool_thread(LPVOID arg)
+#else // Building for Unix
+void* workerpool_thread(void* arg)
+#endif
+{
+	workerpool_struct* pool = (workerpool_struct*)arg;
+	unsigned int job = 0;
+	unsigned int run = 0;
+	POOL_LOCK(pool);
+	workerNumber = pool->Started++;
+	while (1)
+	{
+		// Sleep until the next run
+		while (pool->Shutdown == 0 && pool->Run == run)
+		{
+			POOL_WAIT(pool->WorkReady, pool);
+		}
+		if (pool->Shutdown != 0)
+		{
+			break;
+		}
+		run = pool->Run;
+
+		while (1)
+		{
+			// Do not run too far ahead of the in order completion, to keep the memory for pending results bounded
+			while (pool->Abort == 0 && pool->NextJob < pool->NumJobs && pool->NextJob >= pool->Completed + pool->Window)
+			{
+				POOL_WAIT(pool->SlotFree, pool);
+			}
+			if (pool->Abort != 0 || pool->NextJob >= pool->NumJobs)
+			{
+				break;
+			}
+			job = pool->NextJob++;
+			POOL_UNLOCK(pool);
+
+			pool->Job(pool->Context, job);
+
+			POOL_LOCK(pool);
+			pool->Finished[job] = 1;
+			POOL_WAKE(pool->JobFinished);
+		}
+
+		// Done with this run
+		pool->Busy--;
+		POOL_WAKE(pool->Idle);
+	}
+	POOL_UNLOCK(pool);
+	return 0;
+}
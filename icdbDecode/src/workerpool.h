@@ -0,0 +1,44 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+#ifndef _WORKERPOOL_H
+#define _WORKERPOOL_H
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define WORKERPOOL_WINDOW 8 // Jobs each thread may run ahead of the in order completion
+
+#ifdef _MSC_VER
+	#define THREAD_LOCAL __declspec(thread)
+#else
+	#define THREAD_LOCAL _Thread_local
+#endif
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern int workerpool_run(unsigned int, unsigned int, void(*Job)(void*, unsigned int), int(*Done)(void*, unsigned int), void*);
+extern int workerpool_start(unsigned int);
+extern void workerpool_stop(void);
+extern int workerpool_shared(void);
+extern unsigned int workerpool_cpus(void);
+extern unsigned int workerpool_worker(void);
+
+#endif //_WORKERPOOL_H
@@ -0,0 +1,914 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include "writer.h"
+#include <stdlib.h>		// Required for malloc
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for strcmp
+#include "log.h"		// Required for myPrint
+#ifdef USE_IO_URING
+	#include <errno.h>				// Required for errno
+	#include <fcntl.h>				// Required for AT_FDCWD, O_WRONLY
+	#include <unistd.h>				// Required for syscall, close
+	#include <sys/mman.h>			// Required for mmap
+	#include <sys/syscall.h>		// Required for __NR_io_uring_setup
+	#include <linux/io_uring.h>		// Required for io_uring_sqe
+#endif
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define WRITER_ENTRIES 256				// Submission queue size of each ring
+#define WRITER_BATCH 64					// Queued operations are handed to the kernel once a closed file reaches this many
+#define WRITER_FILES 64					// Files in flight per ring, each one uses a direct descriptor
+#define WRITER_CHUNKS 16				// Output buffers per ring, bounds the memory of the writes in flight
+#define WRITER_CHUNK_SIZE 0x40000		// Output buffer for data that does not stay mapped (256 KiB)
+#define WRITER_MAX_WRITE 0x40000000		// Longer writes are split, the kernel writes at most 2 GiB at once (1 GiB)
+#define WRITER_OP_OPEN 1				// Operation codes kept in the user data of each entry
+#define WRITER_OP_WRITE 2
+#define WRITER_OP_CLOSE 3
+
+/*
+******************************************************************
+* Structures
+******************************************************************
+*/
+#ifdef USE_IO_URING
+typedef struct writer_file_struct
+{
+	char* Path; // Destination, NULL if the direct descriptor is free
+	unsigned int Pending; // Operations queued or in flight
+	int Closed; // Close is queued, the descriptor is free once nothing is pending
+	int Failed; // An operation failed, the file is incomplete
+}writer_file_struct;
+
+typedef struct writer_struct
+{
+	int Ring; // io_uring file descriptor
+	void* SqMap; // Mapped submission ring
+	size_t SqMapSize;
+	void* CqMap; // Mapped completion ring, same as SqMap on newer kernels
+	size_t CqMapSize;
+	struct io_uring_sqe* Sqe; // Mapped submission entries
+	size_t SqeSize;
+	unsigned int* SqTail;
+	unsigned int SqMask;
+	unsigned int SqEntries;
+	unsigned int* CqHead;
+	unsigned int* CqTail;
+	struct io_uring_cqe* Cqe;
+	unsigned int CqMask;
+	unsigned int CqEntries;
+	unsigned int Tail; // Next free submission entry
+	unsigned int Queued; // Entries not handed to the kernel yet
+	unsigned int Inflight; // Entries handed to the kernel and not completed
+	writer_file_struct File[WRITER_FILES]; // Files in flight, by direct descriptor
+	int Current; // File being written, -1 if none
+	uint64_t Offset; // Write position in the current file
+	uint8_t* Chunk[WRITER_CHUNKS]; // Output buffers, allocated on first use
+	uint8_t ChunkBusy[WRITER_CHUNKS]; // Buffer is being filled or written
+	int Fill; // Buffer collecting the output of the current file, -1 if none
+	size_t FillLength; // Bytes in the collecting buffer
+	unsigned int Failed; // Files that could not be written completely
+	int Probe; // Testing the ring, failures are expected and not reported
+}writer_struct;
+#endif
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+#ifdef USE_IO_URING
+int ringSetup(writer_struct*);
+void ringFree(writer_struct*);
+int ringEnter(writer_struct*, unsigned int, unsigned int, unsigned int);
+struct io_uring_sqe* queueEntry(writer_struct*, unsigned int, uint8_t, int, uint32_t);
+int queueWrite(writer_struct*, const void*, size_t, int);
+int submitQueued(writer_struct*);
+int flushQueued(writer_struct*);
+int waitCompletion(writer_struct*);
+void reapCompletions(writer_struct*);
+int takeChunk(writer_struct*);
+void failFile(writer_struct*, int);
+#endif
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+unsigned int writerBackend = WRITER_STDIO; // Selected backend
+
+// Available backends, selected at runtime by name. Optional ones are added at build time
+const char* writer[] =
+{
+	"stdio",
+#ifdef USE_IO_URING
+	"uring",
+#endif
+};
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	writer_name()
+*
+* - description: 	Returns the name of a backend, used to list all backends
+*
+* - parameter: 		backend number
+*
+* - return value: 	name or NULL if there is no such backend
+******************************************************************
+*/
+const char* writer_name(unsigned int backend)
+{
+	if (backend >= sizeof(writer) / sizeof(char*))
+	{
+		return NULL;
+	}
+	return writer[backend];
+}
+
+/*
+******************************************************************
+* - function name:	writer_select()
+*
+* - description: 	Selects the backend used to write the extracted files
+*
+* - parameter: 		name of backend
+*
+* - return value: 	0 if selected, -1 if the backend is not available in this build
+******************************************************************
+*/
+int writer_select(char* name)
+{
+	for (unsigned int i = 0; writer_name(i) != NULL; i++)
+	{
+		if (strcmp(writer_name(i), name) == 0)
+		{
+			writerBackend = i;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+#ifdef USE_IO_URING
+/*
+******************************************************************
+* - function name:	writer_create()
+*
+* - description: 	Creates the io_uring writer of one worker thread. A file that always exists is written once,
+*					so kernels without direct descriptors (before Linux 5.15) or with io_uring disabled are detected
+*
+* - parameter: 		-
+*
+* - return value: 	writer handle, NULL if files are written through stdio
+******************************************************************
+*/
+void* writer_create(void)
+{
+	if (writerBackend != WRITER_URING)
+	{
+		return NULL;
+	}
+	writer_struct* Writer = calloc(1, sizeof(writer_struct));
+	if (Writer == NULL)
+	{
+		return NULL;
+	}
+	Writer->Ring = -1;
+	Writer->Current = -1;
+	Writer->Fill = -1;
+	Writer->Probe = 1;
+	if (ringSetup(Writer) != 0 || writer_open(Writer, "/dev/null") != 0 || writer_close(Writer) != 0 || writer_sync(Writer) != 0)
+	{
+		ringFree(Writer);
+		free(Writer);
+		return NULL;
+	}
+	Writer->Probe = 0;
+	return Writer;
+}
+
+/*
+******************************************************************
+* - function name:	writer_open()
+*
+* - description: 	Starts the next file. The open is only queued, it is handed to the kernel together with the writes
+*
+* - parameter: 		writer handle; zero terminated path
+*
+* - return value: 	0 on success, -1 if out of memory
+******************************************************************
+*/
+int writer_open(void* writer, char* path)
+{
+	writer_struct* Writer = (writer_struct*)writer;
+	int Slot = -1;
+	if (Writer->Current >= 0)
+	{
+		writer_close(Writer);
+	}
+	// Wait for a free direct descriptor
+	while (Slot < 0)
+	{
+		for (int i = 0; i < WRITER_FILES && Slot < 0; i++)
+		{
+			if (Writer->File[i].Path == NULL)
+			{
+				Slot = i;
+			}
+		}
+		if (Slot < 0 && (submitQueued(Writer) != 0 || waitCompletion(Writer) != 0))
+		{
+			return -1;
+		}
+	}
+	writer_file_struct* File = &Writer->File[Slot];
+	File->Path = malloc(strlen(path) + 1);
+	if (File->Path == NULL)
+	{
+		return -1;
+	}
+	strcpy(File->Path, path); // Read by the kernel when the open is submitted
+	File->Pending = 0;
+	File->Closed = 0;
+	File->Failed = 0;
+	Writer->Current = Slot;
+	Writer->Offset = 0;
+
+	struct io_uring_sqe* Entry = queueEntry(Writer, WRITER_OP_OPEN, IORING_OP_OPENAT, -1, 0);
+	if (Entry == NULL)
+	{
+		failFile(Writer, Slot);
+		return 0;
+	}
+	Entry->fd = AT_FDCWD;
+	Entry->addr = (uint64_t)(uintptr_t)File->Path;
+	Entry->len = 0666;
+	Entry->open_flags = O_WRONLY | O_CREAT | O_TRUNC;
+	Entry->file_index = Slot + 1; // Install as direct descriptor, no file descriptor of the process is used
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	writer_write()
+*
+* - description: 	Appends data to the current file. Data that stays valid until writer_sync (e.g. mapped from the database)
+*					is written directly, other data is collected in an output buffer first
+*
+* - parameter: 		writer handle; pointer to data; length of data; 1 if the data stays valid
+*
+* - return value: 	0 on success, -1 if the file can not be written
+******************************************************************
+*/
+int writer_write(void* writer, const void* data, size_t length, int stable)
+{
+	writer_struct* Writer = (writer_struct*)writer;
+	if (Writer->Current < 0 || Writer->File[Writer->Current].Failed == 1)
+	{
+		return -1;
+	}
+	const uint8_t* Data = (const uint8_t*)data;
+	while (length > 0)
+	{
+		size_t Length = length;
+		if (stable == 1)
+		{
+			// Keep the order of buffered and direct data
+			if (Writer->Fill >= 0 && Writer->FillLength > 0 && queueWrite(Writer, Writer->Chunk[Writer->Fill], Writer->FillLength, Writer->Fill) != 0)
+			{
+				return -1;
+			}
+			Length = length < WRITER_MAX_WRITE ? length : WRITER_MAX_WRITE;
+			if (queueWrite(Writer, Data, Length, -1) != 0)
+			{
+				return -1;
+			}
+		}
+		else
+		{
+			if (Writer->Fill < 0)
+			{
+				Writer->Fill = takeChunk(Writer);
+				Writer->FillLength = 0;
+				if (Writer->Fill < 0)
+				{
+					failFile(Writer, Writer->Current);
+					return -1;
+				}
+			}
+			if (Length > WRITER_CHUNK_SIZE - Writer->FillLength)
+			{
+				Length = WRITER_CHUNK_SIZE - Writer->FillLength;
+			}
+			memcpy(Writer->Chunk[Writer->Fill] + Writer->FillLength, Data, Length);
+			Writer->FillLength += Length;
+			if (Writer->FillLength == WRITER_CHUNK_SIZE && queueWrite(Writer, Writer->Chunk[Writer->Fill], Writer->FillLength, Writer->Fill) != 0)
+			{
+				return -1;
+			}
+		}
+		Data += Length;
+		length -= Length;
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	writer_close()
+*
+* - description: 	Finishes the current file. The close is queued after the writes, the caller does not wait for them
+*
+* - parameter: 		writer handle
+*
+* - return value: 	0 on success, -1 if the file can not be written
+******************************************************************
+*/
+int writer_close(void* writer)
+{
+	writer_struct* Writer = (writer_struct*)writer;
+	int Slot = Writer->Current;
+	int error = 0;
+	if (Slot < 0)
+	{
+		return 0;
+	}
+	if (Writer->Fill >= 0)
+	{
+		if (Writer->FillLength > 0)
+		{
+			error = queueWrite(Writer, Writer->Chunk[Writer->Fill], Writer->FillLength, Writer->Fill);
+		}
+		else
+		{
+			Writer->ChunkBusy[Writer->Fill] = 0;
+			Writer->Fill = -1;
+		}
+	}
+	// Even if an earlier operation failed the close runs, hard links do not cancel the rest of the chain
+	struct io_uring_sqe* Entry = queueEntry(Writer, WRITER_OP_CLOSE, IORING_OP_CLOSE, -1, 0);
+	Writer->Current = -1;
+	Writer->File[Slot].Closed = 1;
+	if (Entry == NULL)
+	{
+		// The direct descriptor stays in use, the ring can not take more entries anyway
+		failFile(Writer, Slot);
+		return -1;
+	}
+	Entry->file_index = Slot + 1;
+	Entry->flags = 0; // Ends the chain of this file
+	if (Writer->Queued >= WRITER_BATCH && submitQueued(Writer) != 0)
+	{
+		return -1;
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* - function name:	writer_sync()
+*
+* - description: 	Hands all queued operations to the kernel and waits until they are done
+*
+* - parameter: 		writer handle
+*
+* - return value: 	number of files that could not be written completely, since the writer was created
+******************************************************************
+*/
+unsigned int writer_sync(void* writer)
+{
+	writer_struct* Writer = (writer_struct*)writer;
+	writer_close(Writer);
+	while (Writer->Queued > 0 || Writer->Inflight > 0)
+	{
+		if (submitQueued(Writer) != 0 || (Writer->Inflight > 0 && waitCompletion(Writer) != 0))
+		{
+			// The kernel does not take or complete the remaining entries, their files stay incomplete
+			for (int i = 0; i < WRITER_FILES; i++)
+			{
+				if (Writer->File[i].Path != NULL && Writer->File[i].Pending > 0)
+				{
+					failFile(Writer, i);
+				}
+			}
+			break;
+		}
+	}
+	return Writer->Failed;
+}
+
+/*
+******************************************************************
+* - function name:	writer_finish()
+*
+* - description: 	Waits for all operations and releases the writer
+*
+* - parameter: 		writer handle
+*
+* - return value: 	number of files that could not be written completely
+******************************************************************
+*/
+unsigned int writer_finish(void* writer)
+{
+	writer_struct* Writer = (writer_struct*)writer;
+	unsigned int Failed = writer_sync(Writer);
+	ringFree(Writer);
+	free(Writer);
+	return Failed;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+
+/*
+******************************************************************
+* - function name:	ringSetup()
+*
+* - description: 	Creates and maps the rings and registers an empty table of direct descriptors
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	0 on success, -1 if io_uring is not available
+******************************************************************
+*/
+int ringSetup(writer_struct* Writer)
+{
+	struct io_uring_params Params;
+	memset(&Params, 0, sizeof(Params));
+	Writer->Ring = (int)syscall(__NR_io_uring_setup, WRITER_ENTRIES, &Params);
+	if (Writer->Ring < 0)
+	{
+		return -1;
+	}
+	Writer->SqMapSize = Params.sq_off.array + Params.sq_entries * sizeof(unsigned int);
+	Writer->CqMapSize = Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+	if ((Params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+	{
+		// Both rings share one mapping
+		Writer->SqMapSize = Writer->SqMapSize > Writer->CqMapSize ? Writer->SqMapSize : Writer->CqMapSize;
+	}
+	Writer->SqMap = mmap(NULL, Writer->SqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Writer->Ring, IORING_OFF_SQ_RING);
+	if (Writer->SqMap == MAP_FAILED)
+	{
+		Writer->SqMap = NULL;
+		return -1;
+	}
+	Writer->CqMap = Writer->SqMap;
+	if ((Params.features & IORING_FEAT_SINGLE_MMAP) == 0)
+	{
+		Writer->CqMap = mmap(NULL, Writer->CqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Writer->Ring, IORING_OFF_CQ_RING);
+		if (Writer->CqMap == MAP_FAILED)
+		{
+			Writer->CqMap = NULL;
+			return -1;
+		}
+	}
+	Writer->SqeSize = Params.sq_entries * sizeof(struct io_uring_sqe);
+	Writer->Sqe = mmap(NULL, Writer->SqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Writer->Ring, IORING_OFF_SQES);
+	if (Writer->Sqe == MAP_FAILED)
+	{
+		Writer->Sqe = NULL;
+		return -1;
+	}
+
+	uint8_t* Sq = (uint8_t*)Writer->SqMap;
+	uint8_t* Cq = (uint8_t*)Writer->CqMap;
+	Writer->SqTail = (unsigned int*)(Sq + Params.sq_off.tail);
+	Writer->SqMask = *(unsigned int*)(Sq + Params.sq_off.ring_mask);
+	Writer->SqEntries = Params.sq_entries;
+	Writer->Tail = *Writer->SqTail;
+	unsigned int* SqArray = (unsigned int*)(Sq + Params.sq_off.array);
+	for (unsigned int i = 0; i < Params.sq_entries; i++)
+	{
+		SqArray[i] = i; // Entries are used in ring order
+	}
+	Writer->CqHead = (unsigned int*)(Cq + Params.cq_off.head);
+	Writer->CqTail = (unsigned int*)(Cq + Params.cq_off.tail);
+	Writer->Cqe = (struct io_uring_cqe*)(Cq + Params.cq_off.cqes);
+	Writer->CqMask = *(unsigned int*)(Cq + Params.cq_off.ring_mask);
+	Writer->CqEntries = Params.cq_entries;
+
+	int Files[WRITER_FILES];
+	for (unsigned int i = 0; i < WRITER_FILES; i++)
+	{
+		Files[i] = -1; // Free direct descriptor
+	}
+	if (syscall(__NR_io_uring_register, Writer->Ring, IORING_REGISTER_FILES, Files, WRITER_FILES) < 0)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	ringFree()
+*
+* - description: 	Unmaps and closes the rings, releases all buffers
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	-
+******************************************************************
+*/
+void ringFree(writer_struct* Writer)
+{
+	if (Writer->Sqe != NULL)
+	{
+		munmap(Writer->Sqe, Writer->SqeSize);
+	}
+	if (Writer->CqMap != NULL && Writer->CqMap != Writer->SqMap)
+	{
+		munmap(Writer->CqMap, Writer->CqMapSize);
+	}
+	if (Writer->SqMap != NULL)
+	{
+		munmap(Writer->SqMap, Writer->SqMapSize);
+	}
+	if (Writer->Ring >= 0)
+	{
+		close(Writer->Ring);
+	}
+	for (unsigned int i = 0; i < WRITER_FILES; i++)
+	{
+		free(Writer->File[i].Path);
+	}
+	for (unsigned int i = 0; i < WRITER_CHUNKS; i++)
+	{
+		free(Writer->Chunk[i]);
+	}
+}
+
+/*
+******************************************************************
+* - function name:	ringEnter()
+*
+* - description: 	Hands entries to the kernel and/or waits for completions
+*
+* - parameter: 		pointer to writer; number of entries to submit; number of completions to wait for; flags
+*
+* - return value: 	number of submitted entries, -1 on error
+******************************************************************
+*/
+int ringEnter(writer_struct* Writer, unsigned int submit, unsigned int wait, unsigned int flags)
+{
+	return (int)syscall(__NR_io_uring_enter, Writer->Ring, submit, wait, flags, NULL, 0);
+}
+
+/*
+******************************************************************
+* - function name:	queueEntry()
+*
+* - description: 	Prepares the next submission entry for the current file, linked to the operations before it.
+*					If the rings are full, the queued entries are handed to the kernel first
+*
+* - parameter: 		pointer to writer; operation code for the user data; io_uring opcode; buffer number or -1; length of write
+*
+* - return value: 	pointer to submission entry, NULL on error
+******************************************************************
+*/
+struct io_uring_sqe* queueEntry(writer_struct* Writer, unsigned int operation, uint8_t opcode, int chunk, uint32_t length)
+{
+	int Slot = Writer->Current;
+	// The completion ring must have room for every entry handed to the kernel
+	while (Writer->Queued == Writer->SqEntries || Writer->Inflight + Writer->Queued >= Writer->CqEntries)
+	{
+		// The kernel takes no more entries, give up on the file instead of retrying forever
+		if (Writer->Queued > 0 ? flushQueued(Writer) != 0 : waitCompletion(Writer) != 0)
+		{
+			return NULL;
+		}
+	}
+	struct io_uring_sqe* Entry = &Writer->Sqe[Writer->Tail & Writer->SqMask];
+	memset(Entry, 0, sizeof(struct io_uring_sqe));
+	Entry->opcode = opcode;
+	Entry->flags = IOSQE_IO_HARDLINK; // Keep the operations of a file in order, also after an error
+	Entry->user_data = ((uint64_t)length << 32) | (operation << 16) | ((unsigned int)(chunk + 1) << 8) | (unsigned int)Slot;
+	Writer->Tail++;
+	__atomic_store_n(Writer->SqTail, Writer->Tail, __ATOMIC_RELEASE);
+	Writer->Queued++;
+	Writer->File[Slot].Pending++;
+	return Entry;
+}
+
+/*
+******************************************************************
+* - function name:	queueWrite()
+*
+* - description: 	Queues a write to the current file at the current position
+*
+* - parameter: 		pointer to writer; pointer to data; length of data (at most WRITER_MAX_WRITE); buffer number or -1
+*
+* - return value: 	0 on success, -1 if the file can not be written
+******************************************************************
+*/
+int queueWrite(writer_struct* Writer, const void* data, size_t length, int chunk)
+{
+	int Slot = Writer->Current;
+	if (chunk >= 0)
+	{
+		Writer->Fill = -1; // Buffer is released when the write completes
+	}
+	struct io_uring_sqe* Entry = queueEntry(Writer, WRITER_OP_WRITE, IORING_OP_WRITE, chunk, (uint32_t)length);
+	if (Entry == NULL)
+	{
+		if (chunk >= 0)
+		{
+			Writer->ChunkBusy[chunk] = 0;
+		}
+		failFile(Writer, Slot);
+		return -1;
+	}
+	Entry->flags |= IOSQE_FIXED_FILE;
+	Entry->fd = Slot;
+	Entry->addr = (uint64_t)(uintptr_t)data;
+	Entry->len = (uint32_t)length;
+	Entry->off = Writer->Offset;
+	Writer->Offset += length;
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	submitQueued()
+*
+* - description: 	Hands all queued entries to the kernel without waiting for them
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	0 on success, -1 on error
+******************************************************************
+*/
+int submitQueued(writer_struct* Writer)
+{
+	while (Writer->Queued > 0)
+	{
+		int Submitted = ringEnter(Writer, Writer->Queued, 0, 0);
+		if (Submitted < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if ((errno == EAGAIN || errno == EBUSY) && Writer->Inflight > 0 && waitCompletion(Writer) == 0)
+			{
+				continue; // Kernel is short of resources, retry once some entries are done
+			}
+			return -1;
+		}
+		Writer->Queued -= (unsigned int)Submitted;
+		Writer->Inflight += (unsigned int)Submitted;
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	flushQueued()
+*
+* - description: 	Hands all queued entries to the kernel in the middle of a file. Entries of later calls are not linked
+*					to the ones handed over now, so the operations of the current file are awaited before it continues
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	0 on success, -1 if the kernel does not take or complete the entries
+******************************************************************
+*/
+int flushQueued(writer_struct* Writer)
+{
+	if (submitQueued(Writer) != 0)
+	{
+		return -1;
+	}
+	while (Writer->Current >= 0 && Writer->File[Writer->Current].Pending > 0)
+	{
+		if (waitCompletion(Writer) != 0)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	waitCompletion()
+*
+* - description: 	Waits for at least one completion and processes all available ones
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	0 on success, -1 on error
+******************************************************************
+*/
+int waitCompletion(writer_struct* Writer)
+{
+	if (Writer->Inflight == 0)
+	{
+		return -1; // Nothing to wait for
+	}
+	while (__atomic_load_n(Writer->CqTail, __ATOMIC_ACQUIRE) == *Writer->CqHead)
+	{
+		if (ringEnter(Writer, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+		{
+			return -1;
+		}
+	}
+	reapCompletions(Writer);
+	return 0;
+}
+
+/*
+******************************************************************
+* - function name:	reapCompletions()
+*
+* - description: 	Processes all available completions. Buffers are released, failed files are reported
+*					and the direct descriptor of a file is free again once its close is done
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	-
+******************************************************************
+*/
+void reapCompletions(writer_struct* Writer)
+{
+	unsigned int Head = *Writer->CqHead;
+	unsigned int Tail = __atomic_load_n(Writer->CqTail, __ATOMIC_ACQUIRE);
+	while (Head != Tail)
+	{
+		struct io_uring_cqe* Completion = &Writer->Cqe[Head & Writer->CqMask];
+		unsigned int Slot = (unsigned int)(Completion->user_data & 0xff);
+		int Chunk = (int)((Completion->user_data >> 8) & 0xff) - 1;
+		unsigned int Operation = (unsigned int)((Completion->user_data >> 16) & 0xff);
+		uint32_t Length = (uint32_t)(Completion->user_data >> 32);
+		writer_file_struct* File = &Writer->File[Slot];
+
+		// A short write is an error as well, the rest of the data would be missing
+		if (Completion->res < 0 || (Operation == WRITER_OP_WRITE && (uint32_t)Completion->res != Length))
+		{
+			failFile(Writer, (int)Slot);
+		}
+		if (Chunk >= 0)
+		{
+			Writer->ChunkBusy[Chunk] = 0;
+		}
+		File->Pending--;
+		Writer->Inflight--;
+		if (File->Pending == 0 && File->Closed == 1)
+		{
+			free(File->Path);
+			File->Path = NULL;
+		}
+		Head++;
+	}
+	__atomic_store_n(Writer->CqHead, Head, __ATOMIC_RELEASE);
+}
+
+/*
+******************************************************************
+* - function name:	takeChunk()
+*
+* - description: 	Returns a free output buffer, waits for a write to complete if all are in use
+*
+* - parameter: 		pointer to writer
+*
+* - return value: 	buffer number, -1 on error
+******************************************************************
+*/
+int takeChunk(writer_struct* Writer)
+{
+	while (1)
+	{
+		for (int i = 0; i < WRITER_CHUNKS; i++)
+		{
+			if (Writer->ChunkBusy[i] == 0)
+			{
+				if (Writer->Chunk[i] == NULL)
+				{
+					Writer->Chunk[i] = malloc(WRITER_CHUNK_SIZE);
+					if (Writer->Chunk[i] == NULL)
+					{
+						return -1;
+					}
+				}
+				Writer->ChunkBusy[i] = 1;
+				return i;
+			}
+		}
+		// All buffers are queued or in flight
+		if (Writer->Queued > 0 ? flushQueued(Writer) != 0 : waitCompletion(Writer) != 0)
+		{
+			return -1;
+		}
+	}
+}
+
+/*
+******************************************************************
+* - function name:	failFile()
+*
+* - description: 	Marks a file as incomplete. Each file is reported and counted once
+*
+* - parameter: 		pointer to writer; direct descriptor of the file
+*
+* - return value: 	-
+******************************************************************
+*/
+void failFile(writer_struct* Writer, int Slot)
+{
+	writer_file_struct* File = &Writer->File[Slot];
+	if (File->Failed == 0)
+	{
+		File->Failed = 1;
+		if (Writer->Probe == 0)
+		{
+			myPrint("Failed to write [%s]!\n", File->Path);
+		}
+		Writer->Failed++;
+	}
+}
+#else
+/*
+******************************************************************
+* - function name:	writer_create()
+*
+* - description: 	Built without io_uring, all files are written through stdio
+*
+* - parameter: 		-
+*
+* - return value: 	NULL
+******************************************************************
+*/
+void* writer_create(void)
+{
+	return NULL;
+}
+
+int writer_open(void* writer, char* path)
+{
+	(void)writer;
+	(void)path;
+	return -1;
+}
+
+int writer_write(void* writer, const void* data, size_t length, int stable)
+{
+	(void)writer;
+	(void)data;
+	(void)length;
+	(void)stable;
+	return -1;
+}
+
+int writer_close(void* writer)
+{
+	(void)writer;
+	return -1;
+}
+
+unsigned int writer_sync(void* writer)
+{
+	(void)writer;
+	return 0;
+}
+
+unsigned int writer_finish(void* writer)
+{
+	(void)writer;
+	return 0;
+}
+#endif
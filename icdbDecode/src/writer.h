@@ -0,0 +1,57 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBdecode
+*
+* This tool can be used to analyze and decompress Siemens EDA (former Mentor Graphics) icdb.dat files.
+* It's intend is to gain understanding of the file format, in order to allow interoperability with other EDA packages.
+*
+* The tool is based on initial research done by Patrick Yeon (https://github.com/patrickyeon/icdb2fs) in 2011.
+* The research was performed by analyzing various icdb.dat files (basically staring at the hex editor for hours),
+* No static or dynamic code analysis of any proprietary executable files was used to gain information about the file format.
+*
+* This project uses the Zlib library (https://www.zlib.net/) for decompression.
+*/
+
+#ifndef _WRITER_H
+#define _WRITER_H
+
+/*
+******************************************************************
+* Global Includes
+******************************************************************
+*/
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <stddef.h>		// Required for size_t
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define WRITER_STDIO 0		// Default, each file is opened, written and closed through stdio
+#define WRITER_URING 1		// Linux io_uring, opens, writes and closes of many files are submitted in batches
+
+/*
+******************************************************************
+* Global Variables
+******************************************************************
+*/
+extern unsigned int writerBackend;
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+extern const char* writer_name(unsigned int);
+extern int writer_select(char*);
+extern void* writer_create(void);
+extern int writer_open(void*, char*);
+extern int writer_write(void*, const void*, size_t, int);
+extern int writer_close(void*);
+extern unsigned int writer_sync(void*);
+extern unsigned int writer_finish(void*);
+
+#endif //_WRITER_H
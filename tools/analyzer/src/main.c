@@ -35,7 +35,7 @@
 ******************************************************************
 */
 int AnalyzerOpen();
-void AnalyzerWrite(FILE*, char*, unsigned int);
+void AnalyzerWrite(cursor_struct*, char*, unsigned int);
 void AnalyzerClose();
 
 /*
@@ -186,7 +186,7 @@ int AnalyzerOpen()
 * - return value: 	-
 ******************************************************************
 */
-void AnalyzerWrite(FILE* sourceFile, char* Key, unsigned int KeyLen)
+void AnalyzerWrite(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	FILE* Datafile = NULL;
 	char* NameTemp = NULL;
@@ -350,6 +350,7 @@ void AnalyzerWrite(FILE* sourceFile, char* Key, unsigned int KeyLen)
 	// Close data file
 	fclose(Datafile);
 	InitKey(&Data);
+	arena_reset(&keyArena); // Keys are written one by one, nothing to keep
 }
 
 /*
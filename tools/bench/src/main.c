@@ -0,0 +1,143 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBbench
+*
+* This tool compares the decompression backends of icdbDecode on the payloads of a SiemensEDA (former Mentor Graphics) icdb.dat database.
+* It is part of icdbDecode.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for printf
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <time.h>		// Required for clock_t
+#include <zlib.h>		// Required for crc32
+#include "../../../icdbDecode/src/unpack.h"		// Required for icdb_open
+#include "../../../icdbDecode/src/inflater.h"	// Required for inflater_select
+#include "../../../icdbDecode/src/log.h"		// Required for quietMode
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define DEFAULT_ROUNDS 5					// Number of passes over all payloads per backend
+#define COMPRESSION_HEADER_SIZE 5			// Header in front of compressed payloads
+#define _CRT_SECURE_NO_DEPRECATE			// Disable insecure function warning in VisualStudio
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+/*
+******************************************************************
+* - function name:	main()
+*
+* - description: 	Application entry point. Reads all payloads with every decompression backend
+*					and compares the time and the inflated data
+*
+* - parameter: 		arguments
+*
+* - return value: 	exit code
+******************************************************************
+*/
+int main(int argc, char** argv)
+{
+	void* icdb = NULL;
+	uint32_t* Checksum = NULL;
+	unsigned int numEntries = 0;
+	unsigned int numCompressed = 0;
+	size_t compressedSize = 0;
+	int rounds = DEFAULT_ROUNDS;
+	int error = 0;
+
+	// Check parameter
+	if (argc < 2)
+	{
+		printf("Usage: icdbBench <icdb.dat> [rounds]\n");
+		return -1;
+	}
+	if (argc > 2 && atoi(argv[2]) > 0)
+	{
+		rounds = atoi(argv[2]);
+	}
+	quietMode = 1;
+	icdb = icdb_open(argv[1]);
+	if (icdb == NULL)
+	{
+		printf("Failed to open [%s]!\n", argv[1]);
+		return -1;
+	}
+
+	// Count compressed payloads
+	nontDecompress = 1;
+	while (icdb_entry(icdb, numEntries) != NULL)
+	{
+		uint8_t* Data = NULL;
+		size_t Size = 0;
+		if (icdb_read(icdb, icdb_entry(icdb, numEntries), &Data, &Size) == 0 && Size > COMPRESSION_HEADER_SIZE &&
+			Data[1] == 0xfd && Data[2] == 0xff && Data[3] == 0xff && Data[4] == 0x01)
+		{
+			numCompressed++;
+			compressedSize += Size;
+		}
+		free(Data);
+		numEntries++;
+	}
+	nontDecompress = 0;
+	printf("%d entries, %d compressed with %zu bytes\n\n", numEntries, numCompressed, compressedSize);
+
+	Checksum = calloc(numEntries + 1, sizeof(uint32_t));
+	if (Checksum == NULL)
+	{
+		icdb_close(&icdb);
+		return -1;
+	}
+
+	// The first backend is the reference for all others
+	printf("Backend\t\tTime\t\tMB/s\tMismatch\n");
+	for (unsigned int backend = 0; inflater_name(backend) != NULL; backend++)
+	{
+		size_t totalSize = 0;
+		unsigned int mismatch = 0;
+		inflater_select((char*)inflater_name(backend));
+		clock_t starttime = clock();
+		for (int round = 0; round < rounds; round++)
+		{
+			for (unsigned int i = 0; i < numEntries; i++)
+			{
+				uint8_t* Data = NULL;
+				size_t Size = 0;
+				if (icdb_read(icdb, icdb_entry(icdb, i), &Data, &Size) != 0)
+				{
+					mismatch += round == 0;
+				}
+				else if (round == 0)
+				{
+					uint32_t crc = (uint32_t)crc32(0, Data, (uInt)Size);
+					if (backend == 0)
+					{
+						Checksum[i] = crc;
+					}
+					mismatch += crc != Checksum[i];
+				}
+				totalSize += Size;
+				free(Data);
+			}
+		}
+		float duration = (float)(clock() - starttime) / (float)CLOCKS_PER_SEC;
+		printf("%-12s\t%fs\t%.1f\t%d\n", inflater_name(backend), duration, duration > 0 ? (float)totalSize / duration / 1000000.0f : 0.0f, mismatch);
+		error |= mismatch != 0;
+	}
+
+	free(Checksum);
+	icdb_close(&icdb);
+	return error;
+}
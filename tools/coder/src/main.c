@@ -35,7 +35,7 @@
 ******************************************************************
 */
 int AnalyzerOpen();
-void AnalyzerWrite(FILE*, char*, unsigned int);
+void AnalyzerWrite(cursor_struct*, char*, unsigned int);
 void AnalyzerClose();
 
 /*
@@ -268,8 +268,7 @@ int AnalyzerOpen()
 	fprintf(Hfile, "* Global Includes\n");
 	fprintf(Hfile, "******************************************************************\n");
 	fprintf(Hfile, "*/\n");
-	fprintf(Hfile, "#include <stdio.h>		// Required for FILE\n");
-	fprintf(Hfile, "#include \"../common.h\"	// Required for key_struct\n");
+	fprintf(Hfile, "#include \"../common.h\"	// Required for key_struct, cursor_struct\n");
 	fprintf(Hfile, "\n");
 	fprintf(Hfile, "/*\n");
 	fprintf(Hfile, "******************************************************************\n");
@@ -300,7 +299,7 @@ int AnalyzerOpen()
 * - return value: 	-
 ******************************************************************
 */
-void AnalyzerWrite(FILE* sourceFile, char* Key, unsigned int KeyLen)
+void AnalyzerWrite(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
 {
 	unsigned int numNames = list_elements(list) - 1;
 	char* nameTemp = NULL;
@@ -365,7 +364,7 @@ void AnalyzerClose()
 	fprintf(Cfile, "* - return value: 	-\n");
 	fprintf(Cfile, "******************************************************************\n");
 	fprintf(Cfile, "*/\n");
-	fprintf(Cfile, "void ProcessKey%s(FILE * sourceFile, char* Key, unsigned int KeyLen)\n", nameBig);
+	fprintf(Cfile, "void ProcessKey%s(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)\n", nameBig);
 	fprintf(Cfile, "{\n");
 	fprintf(Cfile, "\t");
 	
@@ -410,7 +409,7 @@ void AnalyzerClose()
 	fprintf(Hfile, "* Global Functions\n");
 	fprintf(Hfile, "******************************************************************\n");
 	fprintf(Hfile, "*/\n");
-	fprintf(Hfile, "extern void ProcessKey%s(FILE*, char*, unsigned int);\n", nameBig);
+	fprintf(Hfile, "extern void ProcessKey%s(cursor_struct*, char*, unsigned int);\n", nameBig);
 	fprintf(Hfile, "extern void Init%s(void);\n", nameBig);
 	fprintf(Hfile, "\n");
 	fprintf(Hfile, "#endif //_%s_H", nameAllBig);
@@ -0,0 +1,230 @@
+/*
+******************************************************************
+* Info
+******************************************************************
+* iCDBscanbench
+*
+* This tool compares the kernels icdbDecode uses to find the end of a block in *.v files (SkipBlock).
+* It is part of icdbDecode.
+*/
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+#include <stdio.h>		// Required for printf
+#include <stdlib.h>		// Required for calloc to work properly
+#include <stdint.h>		// Required for int32_t, uint32_t, ...
+#include <string.h>		// Required for memcpy
+#include <time.h>		// Required for clock_t
+#include "../../../icdbDecode/src/cursor.h"		// Required for cursor_skip_word
+#include "../../../icdbDecode/src/common.h"		// Required for parseFile
+#include "../../../icdbDecode/src/log.h"		// Required for quietMode
+
+/*
+******************************************************************
+* Global Defines
+******************************************************************
+*/
+#define DEFAULT_SIZE 64						// Size of the generated buffer (MiB)
+#define DEFAULT_ROUNDS 10					// Number of passes over the buffer per kernel
+#define SHORT_BLOCK 64						// Distance of the terminators in the short block test (bytes)
+#define BLOCK_END_BYTE 0xFF					// Terminator of string blocks
+#define BLOCK_END_WORD 0x4FFFFFFF			// Terminator of all other blocks
+#define _CRT_SECURE_NO_DEPRECATE			// Disable insecure function warning in VisualStudio
+
+/*
+******************************************************************
+* Function Prototypes
+******************************************************************
+*/
+void fillBuffer(uint8_t*, size_t, size_t);
+size_t scanBuffer(uint8_t*, size_t, int, size_t*);
+void SkipKey(cursor_struct*, char*, unsigned int);
+
+/*
+******************************************************************
+* Global Functions
+******************************************************************
+*/
+/*
+******************************************************************
+* - function name:	main()
+*
+* - description: 	Application entry point. Scans a generated buffer with long and short blocks with every kernel,
+*					and optionally parses *.v files without consuming any key
+*
+* - parameter: 		arguments
+*
+* - return value: 	exit code
+******************************************************************
+*/
+int main(int argc, char** argv)
+{
+	size_t Size = (size_t)DEFAULT_SIZE << 20;
+	int rounds = DEFAULT_ROUNDS;
+	int error = 0;
+	int firstFile = 1;
+	size_t BlockSize[2] = { 0, SHORT_BLOCK };
+
+	if (argc > 1 && atoi(argv[1]) > 0)
+	{
+		Size = (size_t)atoi(argv[1]) << 20;
+		firstFile = 2;
+	}
+	uint8_t* Buffer = malloc(Size);
+	if (Buffer == NULL)
+	{
+		printf("Usage: icdbScanBench [buffer size in MiB] [file.v ...]\n");
+		return -1;
+	}
+	quietMode = 1;
+
+	// Long blocks: one terminator at the end. Short blocks: a terminator every SHORT_BLOCK bytes
+	BlockSize[0] = Size;
+	for (unsigned int b = 0; b < 2; b++)
+	{
+		size_t Block = BlockSize[b];
+		fillBuffer(Buffer, Size, Block);
+		printf("%zu MiB, terminator every %zu bytes\n", Size >> 20, Block);
+		printf("Kernel\t\tByte MB/s\tWord MB/s\tMismatch\n");
+		size_t ReferenceByte = 0;
+		size_t ReferenceWord = 0;
+		for (unsigned int k = 0; cursor_kernel_name(k) != NULL; k++)
+		{
+			size_t FoundByte = 0;
+			size_t FoundWord = 0;
+			size_t SumByte = 0;
+			size_t SumWord = 0;
+			cursor_kernel_select((char*)cursor_kernel_name(k));
+
+			clock_t starttime = clock();
+			for (int round = 0; round < rounds; round++)
+			{
+				FoundByte = scanBuffer(Buffer, Size, 1, &SumByte);
+			}
+			float durationByte = (float)(clock() - starttime) / (float)CLOCKS_PER_SEC;
+			starttime = clock();
+			for (int round = 0; round < rounds; round++)
+			{
+				FoundWord = scanBuffer(Buffer, Size, 0, &SumWord);
+			}
+			float durationWord = (float)(clock() - starttime) / (float)CLOCKS_PER_SEC;
+
+			// The scalar kernel is the reference for all others
+			if (k == 0)
+			{
+				ReferenceByte = SumByte;
+				ReferenceWord = SumWord;
+			}
+			int mismatch = (SumByte != ReferenceByte) || (SumWord != ReferenceWord) || FoundByte != Size / Block || FoundWord != Size / Block;
+			printf("%-12s\t%.1f\t\t%.1f\t\t%d\n", cursor_kernel_name(k),
+				durationByte > 0 ? (float)Size * rounds / durationByte / 1000000.0f : 0.0f,
+				durationWord > 0 ? (float)Size * rounds / durationWord / 1000000.0f : 0.0f, mismatch);
+			error |= mismatch;
+		}
+		printf("\n");
+	}
+	free(Buffer);
+
+	// Real files: every key is skipped without being parsed
+	for (int i = firstFile; i < argc; i++)
+	{
+		printf("[%s]\nKernel\t\tTime\n", argv[i]);
+		for (unsigned int k = 0; cursor_kernel_name(k) != NULL; k++)
+		{
+			cursor_kernel_select((char*)cursor_kernel_name(k));
+			clock_t starttime = clock();
+			for (int round = 0; round < rounds; round++)
+			{
+				error |= parseFile(NULL, 0, argv[i], (uint32_t)strlen(argv[i]) + 1, SkipKey) != 0;
+			}
+			printf("%-12s\t%fs\n", cursor_kernel_name(k), (float)(clock() - starttime) / (float)CLOCKS_PER_SEC);
+		}
+		printf("\n");
+	}
+	return error;
+}
+
+/*
+******************************************************************
+* Local Functions
+******************************************************************
+*/
+/*
+******************************************************************
+* - function name:	fillBuffer()
+*
+* - description: 	Fills a buffer with random data free of terminators, and places a 32 bit terminator
+*					at the end of every block. Its first byte is the 8 bit terminator
+*
+* - parameter: 		buffer; size of buffer; size of blocks (multiple of 4)
+*
+* - return value: 	-
+******************************************************************
+*/
+void fillBuffer(uint8_t* buffer, size_t size, size_t block)
+{
+	uint32_t Random = 1;
+	uint32_t Terminator = BLOCK_END_WORD;
+	for (size_t i = 0; i < size; i++)
+	{
+		Random = Random * 1103515245 + 12345;
+		buffer[i] = (uint8_t)((Random >> 16) % BLOCK_END_BYTE);
+	}
+	for (size_t i = block; i <= size; i += block)
+	{
+		memcpy(buffer + i - sizeof(uint32_t), &Terminator, sizeof(uint32_t));
+	}
+}
+
+/*
+******************************************************************
+* - function name:	scanBuffer()
+*
+* - description: 	Skips all blocks of a buffer with the selected kernel
+*
+* - parameter: 		buffer; size of buffer; 1 for 8 bit terminators, 0 for 32 bit terminators; pointer to sum of all block ends
+*
+* - return value: 	number of blocks found
+******************************************************************
+*/
+size_t scanBuffer(uint8_t* buffer, size_t size, int byte, size_t* sum)
+{
+	cursor_struct Cursor = { 0 };
+	size_t Found = 0;
+	Cursor.Data = buffer;
+	Cursor.Size = size;
+	*sum = 0;
+	while (Cursor.Position < Cursor.Size)
+	{
+		if (byte == 1)
+		{
+			cursor_skip_byte(&Cursor, BLOCK_END_BYTE);
+			Cursor.Position = min(Cursor.Position + sizeof(uint32_t) - sizeof(uint8_t), Cursor.Size); // Rest of the word
+		}
+		else
+		{
+			cursor_skip_word(&Cursor, BLOCK_END_WORD);
+		}
+		*sum += Cursor.Position;
+		Found++;
+	}
+	return Found;
+}
+
+/*
+******************************************************************
+* - function name:	SkipKey()
+*
+* - description: 	Key callback of parseFile that consumes nothing, so every key is skipped by SkipBlock
+*
+* - parameter: 		pointer to source cursor; Key; length of key
+*
+* - return value: 	-
+******************************************************************
+*/
+void SkipKey(cursor_struct* sourceFile, char* Key, unsigned int KeyLen)
+{
+}